@@ -32,7 +32,8 @@ const float MARGIN = 10.0f;
 const float STATUS_BAR_HEIGHT = 24.0f;
 
 Application::Application()
-    : sortManager_(), visualizationManager_(sortManager_), showControlPanel_(true)
+    : sortManager_(), visualizationManager_(sortManager_), showControlPanel_(true),
+      costModelEnabled_(false), comparisonCostNs_(100.0f), readCostNs_(10.0f), writeCostNs_(1000.0f)
 {
     setupStyle();
 
@@ -156,10 +157,7 @@ void Application::render()
         // Limit to a reasonable number
         iterationsPerFrame = std::min(iterationsPerFrame, 50);
 
-        for (int i = 0; i < iterationsPerFrame && sortManager_.isSorting(); i++)
-        {
-            sortManager_.updateSort();
-        }
+        sortManager_.updateSort(iterationsPerFrame);
     }
 
     // Render status bar at the bottom of the screen
@@ -243,6 +241,55 @@ void Application::renderMainWindow()
 
         ImGui::Spacing();
 
+        // Turbo mode skips the animation and sorts at full speed
+        bool turbo = sortManager_.isTurboMode();
+        if (ImGui::Checkbox("Turbo Mode", &turbo))
+        {
+            sortManager_.setTurboMode(turbo);
+        }
+
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::BeginTooltip();
+            ImGui::TextUnformatted("Run the algorithm to completion at native speed instead of animating it.");
+            ImGui::EndTooltip();
+        }
+
+        // The cost model charges every comparison, read and write a modeled
+        // cost, for costly keys or write-expensive storage
+        bool costChanged = ImGui::Checkbox("Cost Model", &costModelEnabled_);
+
+        if (ImGui::IsItemHovered())
+        {
+            ImGui::BeginTooltip();
+            ImGui::TextUnformatted("Charge each comparison, key read and key write the set cost and compare the modeled times of the algorithms run.");
+            ImGui::EndTooltip();
+        }
+
+        if (costModelEnabled_)
+        {
+            costChanged |= ImGui::SliderFloat("##Comparison Cost", &comparisonCostNs_, 0.0f, 10000.0f,
+                                              "%.0f ns per comparison", ImGuiSliderFlags_Logarithmic);
+            costChanged |= ImGui::SliderFloat("##Read Cost", &readCostNs_, 0.0f, 10000.0f,
+                                              "%.0f ns per read", ImGuiSliderFlags_Logarithmic);
+            costChanged |= ImGui::SliderFloat("##Write Cost", &writeCostNs_, 0.0f, 10000.0f,
+                                              "%.0f ns per write", ImGuiSliderFlags_Logarithmic);
+        }
+
+        if (costChanged)
+        {
+            CostModel model;
+            if (costModelEnabled_)
+            {
+                model.comparisonSeconds = comparisonCostNs_ * 1e-9;
+                model.readSeconds = readCostNs_ * 1e-9;
+                model.writeSeconds = writeCostNs_ * 1e-9;
+            }
+            sortManager_.setCostModel(model);
+        }
+
+        ImGui::Spacing();
+
         // Reset button
         if (ImGui::Button("Reset Array", ImVec2(ImGui::GetContentRegionAvail().x, 30.0f)))
         {
@@ -295,8 +342,9 @@ void Application::renderControlPanel()
         // Get metrics data
         const auto &metrics = sortManager_.getMetrics();
         float elapsedTime = metrics.getElapsedTime();
-        int comparisons = metrics.comparisons;
-        int swaps = metrics.swaps;
+        double computeTime = metrics.getComputeTime();
+        long long comparisons = metrics.comparisons;
+        long long swaps = metrics.swaps;
         float fps = ImGui::GetIO().Framerate;
 
         // Progress indicator
@@ -330,17 +378,88 @@ void Application::renderControlPanel()
         ImGui::TableNextColumn();
         ImGui::TextColored(COLOR_PRIMARY, "%.3f sec", elapsedTime);
 
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("Algorithm Time:");
+        ImGui::TableNextColumn();
+        ImGui::TextColored(COLOR_PRIMARY, "%.3f ms", computeTime * 1000.0);
+
         ImGui::TableNextRow();
         ImGui::TableNextColumn();
         ImGui::Text("Comparisons:");
         ImGui::TableNextColumn();
-        ImGui::TextColored(COLOR_PRIMARY, "%d", comparisons);
+        ImGui::TextColored(COLOR_PRIMARY, "%lld", comparisons);
+
+        // Comparisons against the log2(n!) floor, writes, and what they would cost
+        if (!metrics.costModel.isFree())
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("Min Comparisons:");
+            ImGui::TableNextColumn();
+            ImGui::TextColored(COLOR_PRIMARY, "%.0f", comparisonLowerBound(arraySize));
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("Writes:");
+            ImGui::TableNextColumn();
+            ImGui::TextColored(COLOR_PRIMARY, "%lld", metrics.writes);
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("Modeled Time:");
+            ImGui::TableNextColumn();
+            ImGui::TextColored(COLOR_PRIMARY, "%.3f ms", metrics.getModeledTime() * 1000.0);
+        }
 
         ImGui::TableNextRow();
         ImGui::TableNextColumn();
         ImGui::Text("Swaps:");
         ImGui::TableNextColumn();
-        ImGui::TextColored(COLOR_PRIMARY, "%d", swaps);
+        ImGui::TextColored(COLOR_PRIMARY, "%lld", swaps);
+
+        // Scratch memory held beyond the array itself
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("Aux Memory:");
+        ImGui::TableNextColumn();
+        if (metrics.auxMemoryBytes < 1024 * 1024)
+        {
+            ImGui::TextColored(COLOR_PRIMARY, "%.1f KB", metrics.auxMemoryBytes / 1024.0);
+        }
+        else
+        {
+            ImGui::TextColored(COLOR_PRIMARY, "%.1f MB", metrics.auxMemoryBytes / (1024.0 * 1024.0));
+        }
+
+        // Load balance of parallel algorithms: least busy thread relative to the busiest
+        if (!metrics.threadWork.empty())
+        {
+            double minBusy = metrics.threadWork[0].busyTime;
+            double maxBusy = metrics.threadWork[0].busyTime;
+            for (const auto &work : metrics.threadWork)
+            {
+                minBusy = std::min(minBusy, work.busyTime);
+                maxBusy = std::max(maxBusy, work.busyTime);
+            }
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("Threads:");
+            ImGui::TableNextColumn();
+            ImGui::TextColored(COLOR_PRIMARY, "%d (%.0f%% balanced)", static_cast<int>(metrics.threadWork.size()),
+                               maxBusy > 0.0 ? 100.0 * minBusy / maxBusy : 100.0);
+        }
+
+        // Time per phase of multi-phase algorithms, summed over threads
+        for (const auto &phase : metrics.phaseTimes)
+        {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::Text("  %s:", phase.name.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextColored(COLOR_PRIMARY, "%.3f ms", phase.seconds * 1000.0);
+        }
 
         ImGui::TableNextRow();
         ImGui::TableNextColumn();
@@ -351,6 +470,60 @@ void Application::renderControlPanel()
         ImGui::EndTable();
     }
 
+    // Modeled cost per element of the last sort of every algorithm run,
+    // priced with the current model so changing a cost reorders them. Only
+    // runs at the current array size are ranked; the others are listed
+    // greyed out below them, since costs do not scale linearly with n.
+    const CostModel &costModel = sortManager_.getCostModel();
+    if (!costModel.isFree() && !sortManager_.getRunRecords().empty())
+    {
+        ImGui::Spacing();
+        ImGui::Separator();
+        ImGui::Spacing();
+
+        ImGui::TextColored(COLOR_TEXT_DIM, "Modeled Costs:");
+
+        struct RankedRun
+        {
+            const SortManager::RunRecord *record;
+            double nsPerElement;
+            bool currentSize;
+        };
+
+        int currentSize = sortManager_.getSortArray().getSize();
+        std::vector<RankedRun> ranked;
+        for (const auto &record : sortManager_.getRunRecords())
+        {
+            double seconds = record.computeTime + costModel.seconds(record.comparisons, record.writes);
+            ranked.push_back({&record, seconds * 1e9 / std::max(1, record.size), record.size == currentSize});
+        }
+        std::sort(ranked.begin(), ranked.end(),
+                  [](const RankedRun &a, const RankedRun &b)
+                  {
+                      if (a.currentSize != b.currentSize)
+                      {
+                          return a.currentSize;
+                      }
+                      return a.nsPerElement < b.nsPerElement;
+                  });
+
+        ImGui::BeginTable("ModeledCostTable", 3, ImGuiTableFlags_SizingStretchProp);
+        for (size_t i = 0; i < ranked.size(); ++i)
+        {
+            const RankedRun &run = ranked[i];
+            const ImVec4 &textColor = run.currentSize ? ImGui::GetStyleColorVec4(ImGuiCol_Text) : COLOR_TEXT_DIM;
+            const ImVec4 &costColor = !run.currentSize ? COLOR_TEXT_DIM : (i == 0 ? COLOR_SUCCESS : COLOR_PRIMARY);
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextColored(textColor, "%s", run.record->algorithm.c_str());
+            ImGui::TableNextColumn();
+            ImGui::TextColored(textColor, "n=%d", run.record->size);
+            ImGui::TableNextColumn();
+            ImGui::TextColored(costColor, "%.1f ns/elem", run.nsPerElement);
+        }
+        ImGui::EndTable();
+    }
+
     ImGui::Spacing();
     ImGui::Separator();
     ImGui::Spacing();
@@ -727,10 +900,94 @@ std::string Application::getAlgorithmComplexity(const std::string &algorithmName
     {
         return "Time: O(n log n) avg, O(n²) worst | Space: O(log n)";
     }
+    else if (algorithmName == "Dual-Pivot Quick Sort")
+    {
+        return "Time: O(n log n) worst with heapsort fallback | Space: O(log n)";
+    }
     else if (algorithmName == "Merge Sort")
     {
         return "Time: O(n log n) | Space: O(n)";
     }
+    else if (algorithmName == "Intro Sort")
+    {
+        return "Time: O(n log n) worst | Space: O(log n)";
+    }
+    else if (algorithmName == "3-Way Quick Sort")
+    {
+        return "Time: O(n log n) avg, O(n) few distinct keys | Space: O(log n)";
+    }
+    else if (algorithmName == "Block Quick Sort")
+    {
+        return "Time: O(n log n) worst | Space: O(log n)";
+    }
+    else if (algorithmName == "Power Sort")
+    {
+        return "Time: O(n + n log r) for r runs | Space: O(n)";
+    }
+    else if (algorithmName == "Parallel Merge Sort")
+    {
+        return "Time: O(n log n / p) on p threads | Space: O(n)";
+    }
+    else if (algorithmName == "Parallel Quick Sort")
+    {
+        return "Time: O(n log n / p) average on p threads | Space: O(log n) per thread";
+    }
+    else if (algorithmName == "Parallel Sample Sort")
+    {
+        return "Time: O(n log n / p) expected on p threads | Space: O(p * buckets * block size)";
+    }
+    else if (algorithmName == "Radix Sort")
+    {
+        return "Time: O(n * w / d) for w-bit keys and d-bit digits | Space: O(n)";
+    }
+    else if (algorithmName == "Counting Sort")
+    {
+        return "Time: O(n + k) for k possible keys | Space: O(k)";
+    }
+    else if (algorithmName == "Parallel MSD Radix Sort")
+    {
+        return "Time: O(n * w / (d * p)) for w-bit keys, d-bit digits, p threads | Space: O(2^d) per thread";
+    }
+    else if (algorithmName == "SIMD Quick Sort")
+    {
+        return "Time: O(n log n) worst, partitions 8 or 16 keys per instruction | Space: O(log n)";
+    }
+    else if (algorithmName == "Heap Sort")
+    {
+        return "Time: O(n log n) worst | Space: O(1)";
+    }
+    else if (algorithmName == "Odd-Even Sort")
+    {
+        return "Time: O(n²), n phases of n/2 independent exchanges | Space: O(1)";
+    }
+    else if (algorithmName.rfind("Quick Sort [", 0) == 0)
+    {
+        return "Time: O(n log n) avg, O(n²) worst | Space: O(log n)";
+    }
+    else if (algorithmName == "In-Place Merge Sort")
+    {
+        return "Time: O(n log² n) worst, O(n) on sorted input | Space: O(1), a 2 KB buffer";
+    }
+    else if (algorithmName == "Flashsort")
+    {
+        return "Time: O(n) for uniform keys, O(n log n) worst | Space: O(n)";
+    }
+    else if (algorithmName == "Learned Sort")
+    {
+        return "Time: O(n) for well-modelled keys, O(n log n) worst | Space: O(n)";
+    }
+    else if (algorithmName == "Binary Insertion Sort")
+    {
+        return "O(n log n) comparisons, O(n^2) moves, O(1) space";
+    }
+    else if (algorithmName == "Merge-Insertion Sort")
+    {
+        return "~n log n - 1.415n comparisons, O(n^2) moves, O(n) space";
+    }
+    else if (algorithmName == "Cycle Sort")
+    {
+        return "O(n^2) comparisons, at most n writes, O(1) space";
+    }
 
     return "Unknown";
 }
@@ -745,10 +1002,94 @@ std::string Application::getAlgorithmDescription(const std::string &algorithmNam
     {
         return "An efficient divide-and-conquer sorting algorithm that works by selecting a 'pivot' element and partitioning the array around the pivot.";
     }
+    else if (algorithmName == "Dual-Pivot Quick Sort")
+    {
+        return "Yaroslavskiy's dual-pivot Quick Sort: two pivots from a sorted sample of five split each range into three parts in one scan, touching memory less often than single-pivot partitioning.";
+    }
     else if (algorithmName == "Merge Sort")
     {
         return "A divide-and-conquer algorithm that divides the input array into two halves, recursively sorts them, then merges the sorted halves.";
     }
+    else if (algorithmName == "Intro Sort")
+    {
+        return "Quick Sort with median-of-three or ninther pivots and insertion sort for small partitions, falling back to heapsort when partitioning goes too deep.";
+    }
+    else if (algorithmName == "3-Way Quick Sort")
+    {
+        return "Quick Sort that splits each range into less-than, equal-to and greater-than the pivot, so runs of duplicate keys are settled in a single pass.";
+    }
+    else if (algorithmName == "Block Quick Sort")
+    {
+        return "Quick Sort whose partition first records misplaced elements in small offset buffers and then swaps them in batches, avoiding branch mispredictions on random data.";
+    }
+    else if (algorithmName == "Power Sort")
+    {
+        return "A stable natural merge sort that finds runs already present in the data and merges them in a near-optimal order with galloping merges, so nearly sorted input sorts in close to linear time.";
+    }
+    else if (algorithmName == "Parallel Merge Sort")
+    {
+        return "A bottom-up merge sort that splits every merge level into equal slices with merge-path partitioning, so all threads do the same amount of work.";
+    }
+    else if (algorithmName == "Parallel Quick Sort")
+    {
+        return "Threads keep their partitions in work-stealing deques: idle threads steal the largest pending partitions, balancing the load when pivots split unevenly.";
+    }
+    else if (algorithmName == "Parallel Sample Sort")
+    {
+        return "An in-place samplesort: keys are classified against up to 255 sampled splitters in cache-sized blocks, the blocks are permuted into their buckets in parallel and the buckets are sorted recursively.";
+    }
+    else if (algorithmName == "Radix Sort")
+    {
+        return "A least-significant-digit radix sort: stable counting passes over 11-bit digits, all counted in one pass, skipping digits that are the same for every key.";
+    }
+    else if (algorithmName == "Counting Sort")
+    {
+        return "Counts how often every key of the array's value range occurs and writes the keys back in order; large ranges are counted tile by tile, very sparse ones are handed to Radix Sort.";
+    }
+    else if (algorithmName == "Parallel MSD Radix Sort")
+    {
+        return "In-place American flag sort: elements are cycled into their 8-bit digit buckets by all threads at once, then buckets are sorted in parallel digit by digit, with Quick Sort for small buckets.";
+    }
+    else if (algorithmName == "SIMD Quick Sort")
+    {
+        return "Quick Sort whose partition compares 8 (AVX2) or 16 (AVX-512) keys per instruction and writes both sides with compress or permutation-table shuffles; the instruction set is chosen at run time, with a scalar fallback.";
+    }
+    else if (algorithmName == "Heap Sort")
+    {
+        return "Heapsort with Floyd's bottom-up sift-down, which skips the comparison with the sifted key on the way down, on a 4-ary heap whose sibling groups are aligned so each level touches one cache line. Also the fallback inside the introsorts.";
+    }
+    else if (algorithmName == "Odd-Even Sort")
+    {
+        return "Parallel Bubble Sort: phases alternately compare-exchange the even and the odd neighbour pairs. The exchanges of a phase are independent, so they run 8 or 16 per vector instruction across all threads, with a barrier between phases.";
+    }
+    else if (algorithmName.rfind("Quick Sort [", 0) == 0)
+    {
+        return "Quick Sort built from compile-time policies: pivot choice, partition scheme and base case, as named in brackets. Every combination is a separate class, so variants can be compared without any runtime dispatch.";
+    }
+    else if (algorithmName == "In-Place Merge Sort")
+    {
+        return "Stable merge sort without an O(n) buffer: short merges go through a fixed 512-key buffer, long ones are split by rotations into smaller merges.";
+    }
+    else if (algorithmName == "Flashsort")
+    {
+        return "Distribution sort: each key's class is interpolated linearly between the minimum and maximum, a cycle-leader permutation moves the keys to their classes and insertion sort finishes the small classes.";
+    }
+    else if (algorithmName == "Learned Sort")
+    {
+        return "Distribution sort with a learned model: a piecewise-linear CDF fitted to a 1% sample predicts each key's class, so skewed keys spread as evenly as uniform ones before insertion sort finishes the classes.";
+    }
+    else if (algorithmName == "Binary Insertion Sort")
+    {
+        return "Insertion sort that finds each key's place by binary search, so inserting the k-th key takes at most log2(k) comparisons. Close to the fewest comparisons possible, which pays off when comparing keys costs far more than moving them.";
+    }
+    else if (algorithmName == "Merge-Insertion Sort")
+    {
+        return "Ford-Johnson: pairs the keys, sorts the larger of each pair recursively, then binary inserts the smaller ones in Jacobsthal-numbered groups so every search spans just under a power of two. Needs fewer comparisons than any other practical sort.";
+    }
+    else if (algorithmName == "Cycle Sort")
+    {
+        return "Writes each key straight to its final position, found by counting the smaller keys, and picks up the key it displaces. No sort writes less: at most n writes, so it suits storage where writes cost far more than reads.";
+    }
 
     return "No description available.";
 }
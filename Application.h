@@ -44,4 +44,8 @@ private:
 
     // UI state
     bool showControlPanel_;
+    bool costModelEnabled_;
+    float comparisonCostNs_; // Costs are kept while the model is off, so it comes back as it was
+    float readCostNs_;
+    float writeCostNs_;
 };
\ No newline at end of file
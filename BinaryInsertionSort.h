@@ -0,0 +1,49 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include <vector>
+
+// Insertion sort that finds each key's place by binary search. Inserting the
+// k-th key takes at most ceil(log2(k)) comparisons, within about 0.5n of the
+// log2(n!) floor in total, so it is a fair choice when comparisons cost far
+// more than moving keys; the moves stay O(n^2). Stable: a key goes after the
+// equal keys already placed. Each update() inserts one key.
+class BinaryInsertionSort final : public SteppedSortAlgorithm<BinaryInsertionSort>
+{
+public:
+    BinaryInsertionSort() : SteppedSortAlgorithm("Binary Insertion Sort"), sortedEnd_(0) {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        sortedEnd_ = array_->empty() ? 0 : 1;
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning || sortedEnd_ >= array_->size())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+
+        int *first = array_->data();
+        binaryInsertionSort(first, first + sortedEnd_, first + sortedEnd_ + 1, metrics_);
+        ++sortedEnd_;
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    std::vector<int> *array_; // Pointer to the original array
+    size_t sortedEnd_;        // Keys before this index are sorted
+};
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include <vector>
+#include <stack>
+
+// Quick Sort built on the branchless block partition: comparison results are
+// buffered as offsets and the swaps are done in batches, so random data no
+// longer pays for a mispredicted branch on every element. Keeps Intro Sort's
+// pivot selection and heapsort fallback, hands small partitions to a sorting
+// network, and skips runs of keys equal to the previous pivot. One partition
+// is processed per update().
+class BlockQuickSort final : public SteppedSortAlgorithm<BlockQuickSort>
+{
+public:
+    BlockQuickSort() : SteppedSortAlgorithm("Block Quick Sort") {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        sortStack_ = std::stack<Partition>();
+
+        if (!array_->empty())
+        {
+            int n = static_cast<int>(array_->size());
+            int depthLimit = 0;
+            for (int size = n; size > 1; size >>= 1)
+            {
+                depthLimit += 2;
+            }
+            sortStack_.push({0, n - 1, depthLimit});
+        }
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning || sortStack_.empty())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+
+        // Get the next partition to process
+        Partition top = sortStack_.top();
+        sortStack_.pop();
+
+        int *data = array_->data();
+        int *first = data + top.low;
+        int *last = data + top.high + 1;
+
+        if (last - first <= networkSortThreshold)
+        {
+            networkSort(first, last, metrics_);
+            return !sortStack_.empty();
+        }
+
+        if (top.depthLimit == 0)
+        {
+            heapSort(first, last, metrics_);
+            return !sortStack_.empty();
+        }
+
+        selectPivotToFront(first, last, metrics_);
+
+        // The key before this range is a lower bound for it; if the pivot
+        // equals it, every key equal to the pivot is already in final position
+        if (top.low > 0)
+        {
+            metrics_.comparisons++;
+            if (!(data[top.low - 1] < *first))
+            {
+                int equalEnd = static_cast<int>(partitionEqualLeft(first, last, metrics_) - data);
+                sortStack_.push({equalEnd + 1, top.high, top.depthLimit});
+                return true;
+            }
+        }
+
+        int pivot = static_cast<int>(partitionBlock(first, last, metrics_) - data);
+
+        // Push the larger side first so the smaller one is processed next
+        Partition left = {top.low, pivot - 1, top.depthLimit - 1};
+        Partition right = {pivot + 1, top.high, top.depthLimit - 1};
+        if (pivot - top.low < top.high - pivot)
+        {
+            std::swap(left, right);
+        }
+        sortStack_.push(left);
+        sortStack_.push(right);
+
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    struct Partition
+    {
+        int low;
+        int high;
+        int depthLimit;
+    };
+
+    static const int networkSortThreshold = 24;
+
+    std::vector<int> *array_; // Pointer to the original array
+    std::stack<Partition> sortStack_;
+};
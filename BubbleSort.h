@@ -3,10 +3,10 @@
 #include "SortAlgorithm.h"
 #include <vector>
 
-class BubbleSort : public SortAlgorithm
+class BubbleSort final : public SteppedSortAlgorithm<BubbleSort>
 {
 public:
-    BubbleSort() : SortAlgorithm("Bubble Sort"), bubbleSortIndex_(0) {}
+    BubbleSort() : SteppedSortAlgorithm("Bubble Sort"), bubbleSortIndex_(0) {}
 
     void initialize(std::vector<int> &array) override
     {
@@ -19,20 +19,21 @@ public:
 
     bool update() override
     {
-        if (!metrics_.isRunning || bubbleSortIndex_ >= array_->size() - 1)
+        if (!metrics_.isRunning || bubbleSortIndex_ >= static_cast<int>(array_->size()) - 1)
         {
             metrics_.isRunning = false;
             return false;
         }
 
         bool swapped = false;
-        for (size_t i = 0; i < array_->size() - bubbleSortIndex_ - 1; i++)
+        for (size_t i = 0; i + bubbleSortIndex_ + 1 < array_->size(); i++)
         {
             metrics_.comparisons++;
             if ((*array_)[i] > (*array_)[i + 1])
             {
                 std::swap((*array_)[i], (*array_)[i + 1]);
                 metrics_.swaps++;
+                metrics_.writes += 2;
                 swapped = true;
             }
         }
@@ -0,0 +1,301 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "RadixSort.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+
+// Counting sort over the key range [minVal, maxVal] announced through
+// setValueRange() (or measured when no range was given): O(n + k) time for k
+// possible keys. Up to tileRange keys a single histogram stays cache resident;
+// larger ranges are split into tiles of tileRange keys, the keys are first
+// distributed to their tile, and every tile is counted with the same small
+// histogram. When k is far larger than n the work is handed to Radix Sort.
+// Keys outside the announced range make it fall back to the measured range.
+//
+// The first update() counts, later ones write out one slice of the result.
+class CountingSort final : public SteppedSortAlgorithm<CountingSort>
+{
+public:
+    CountingSort() : SteppedSortAlgorithm("Counting Sort") {}
+
+    void setValueRange(int minVal, int maxVal) override
+    {
+        hasRange_ = minVal <= maxVal;
+        rangeMin_ = minVal;
+        rangeMax_ = maxVal;
+    }
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        mode_ = Mode::Count;
+        radix_.reset();
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        switch (mode_)
+        {
+        case Mode::Count:
+            count();
+            break;
+
+        case Mode::Write:
+            writeSlice();
+            break;
+
+        case Mode::WriteTiles:
+            writeTile();
+            break;
+
+        case Mode::Fallback:
+        {
+            long long writesBefore = radix_->getMetrics().writes;
+            bool running = radix_->update();
+            metrics_.writes += radix_->getMetrics().writes - writesBefore;
+            if (!running)
+            {
+                mode_ = Mode::Done;
+            }
+            break;
+        }
+
+        case Mode::Done:
+            break;
+        }
+
+        if (mode_ == Mode::Done)
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    enum class Mode
+    {
+        Count,      // Histogram not built yet
+        Write,      // Writing keys straight from the histogram
+        WriteTiles, // Counting and writing one tile per update()
+        Fallback,   // Range too sparse: Radix Sort does the work
+        Done
+    };
+
+    static const int tileBits = 16;
+    static const int tileRange = 1 << tileBits; // 256 KiB of counts, L2 resident
+    static const int sparseFactor = 8;          // Use Radix Sort once k > 8n + tileRange
+    static const int writeSlices = 16;          // Updates spent writing the output
+
+    // Build the histogram for the announced range, or the measured one if a
+    // key turns out to lie outside it
+    void count()
+    {
+        if (array_->size() < 2)
+        {
+            mode_ = Mode::Done;
+            return;
+        }
+
+        int low = rangeMin_;
+        int high = rangeMax_;
+        if (!hasRange_)
+        {
+            measureRange(low, high);
+        }
+
+        if (!countKeys(low, high))
+        {
+            measureRange(low, high);
+            countKeys(low, high);
+        }
+    }
+
+    void measureRange(int &low, int &high)
+    {
+        auto range = std::minmax_element(array_->begin(), array_->end());
+        low = *range.first;
+        high = *range.second;
+        metrics_.comparisons += 3 * static_cast<long long>(array_->size()) / 2;
+    }
+
+    // Choose the strategy for keys in [low, high] and count them; returns
+    // false if some key lies outside the range
+    bool countKeys(int low, int high)
+    {
+        low_ = low;
+        uint64_t range = static_cast<uint64_t>(static_cast<int64_t>(high) - low) + 1;
+
+        if (range > static_cast<uint64_t>(sparseFactor) * array_->size() + tileRange)
+        {
+            radix_ = std::make_unique<RadixSort>();
+            radix_->initialize(*array_);
+            metrics_.noteAuxMemory(radix_->getMetrics().auxMemoryBytes);
+            mode_ = Mode::Fallback;
+            return true;
+        }
+
+        if (range <= static_cast<uint64_t>(tileRange))
+        {
+            return countDirect(static_cast<size_t>(range));
+        }
+        return distributeTiles(static_cast<size_t>(range));
+    }
+
+    uint32_t offsetOf(int key) const
+    {
+        return static_cast<uint32_t>(key) - static_cast<uint32_t>(low_);
+    }
+
+    bool countDirect(size_t range)
+    {
+        counts_.assign(range, 0);
+        metrics_.noteAuxMemory(static_cast<long long>(range * sizeof(unsigned int)));
+        bool within = true;
+        for (int key : *array_)
+        {
+            uint32_t offset = offsetOf(key);
+            if (offset < range)
+            {
+                ++counts_[offset];
+            }
+            else
+            {
+                within = false;
+            }
+        }
+
+        nextValue_ = 0;
+        output_ = 0;
+        mode_ = Mode::Write;
+        return within;
+    }
+
+    // Write the keys of the next slice of the histogram
+    void writeSlice()
+    {
+        int *out = array_->data();
+        size_t n = array_->size();
+        size_t target = std::min(n, output_ + (n + writeSlices - 1) / writeSlices);
+
+        size_t start = output_;
+        uint32_t key = static_cast<uint32_t>(low_) + static_cast<uint32_t>(nextValue_);
+        while (output_ < target)
+        {
+            // Most counts are tiny when k is close to n, so a plain loop beats fill_n
+            for (unsigned int count = counts_[nextValue_++]; count > 0; --count)
+            {
+                out[output_++] = static_cast<int>(key);
+            }
+            ++key;
+        }
+        metrics_.writes += static_cast<long long>(output_ - start);
+
+        if (output_ >= n)
+        {
+            mode_ = Mode::Done;
+        }
+    }
+
+    // Large range: move every key into its tile's region of the buffer
+    bool distributeTiles(size_t range)
+    {
+        size_t n = array_->size();
+        size_t tiles = (range + tileRange - 1) / tileRange;
+
+        tileStart_.assign(tiles + 1, 0);
+        for (int key : *array_)
+        {
+            uint32_t offset = offsetOf(key);
+            if (offset >= range)
+            {
+                return false;
+            }
+            ++tileStart_[(offset >> tileBits) + 1];
+        }
+        for (size_t t = 0; t < tiles; ++t)
+        {
+            tileStart_[t + 1] += tileStart_[t];
+        }
+
+        buffer_.resize(n);
+        std::vector<size_t> next(tileStart_.begin(), tileStart_.end() - 1);
+        for (int key : *array_)
+        {
+            buffer_[next[offsetOf(key) >> tileBits]++] = key;
+        }
+        metrics_.writes += static_cast<long long>(n);
+
+        counts_.assign(tileRange, 0);
+        metrics_.noteAuxMemory(static_cast<long long>(n * sizeof(int) + (2 * tiles + 1) * sizeof(size_t) + tileRange * sizeof(unsigned int)));
+        nextTile_ = 0;
+        mode_ = Mode::WriteTiles;
+        return true;
+    }
+
+    // Count one tile with the cache-resident histogram and write it out
+    void writeTile()
+    {
+        size_t begin = tileStart_[nextTile_];
+        size_t end = tileStart_[nextTile_ + 1];
+
+        if (begin < end)
+        {
+            std::fill(counts_.begin(), counts_.end(), 0);
+            for (size_t i = begin; i < end; ++i)
+            {
+                ++counts_[offsetOf(buffer_[i]) & (tileRange - 1)];
+            }
+
+            int *out = array_->data() + begin;
+            uint32_t key = static_cast<uint32_t>(low_) + static_cast<uint32_t>(nextTile_ << tileBits);
+            for (int value = 0; value < tileRange; ++value, ++key)
+            {
+                for (unsigned int count = counts_[value]; count > 0; --count)
+                {
+                    *out++ = static_cast<int>(key);
+                }
+            }
+            metrics_.writes += static_cast<long long>(end - begin);
+        }
+
+        if (++nextTile_ + 1 >= tileStart_.size())
+        {
+            mode_ = Mode::Done;
+        }
+    }
+
+    std::vector<int> *array_; // Pointer to the original array
+    bool hasRange_ = false;
+    int rangeMin_ = 0;
+    int rangeMax_ = 0;
+    int low_ = 0; // Smallest possible key of the range in use
+    Mode mode_ = Mode::Count;
+
+    std::vector<unsigned int> counts_; // Histogram of the whole range or of one tile
+    size_t nextValue_ = 0;
+    size_t output_ = 0;
+
+    std::vector<size_t> tileStart_; // Start of each tile's keys in buffer_
+    std::vector<int> buffer_;       // Keys grouped by tile
+    size_t nextTile_ = 0;
+
+    std::unique_ptr<RadixSort> radix_;
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include <vector>
+#include <utility>
+
+// Cycle sort writes every key straight to its final position, so a key that
+// is out of place is written exactly once and one already in place not at
+// all: at most n writes, the fewest any sort can do, which is what counts on
+// storage where writes are expensive. A key's position is found by counting
+// the smaller keys after the start of its cycle, which takes O(n^2)
+// comparisons. Equal keys go to the next free slot of their run. Each
+// update() places one key.
+class CycleSort final : public SteppedSortAlgorithm<CycleSort>
+{
+public:
+    CycleSort() : SteppedSortAlgorithm("Cycle Sort"), cycleStart_(0), held_(0), inCycle_(false) {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        cycleStart_ = 0;
+        held_ = 0;
+        inCycle_ = false;
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        int n = static_cast<int>(array_->size());
+        int *data = array_->data();
+
+        // Locate the held key's place, or else start the next cycle, skipping
+        // keys that are already in place
+        int position = cycleStart_;
+        if (inCycle_)
+        {
+            position = positionOf(data, n, held_);
+        }
+        while (!inCycle_ && cycleStart_ < n - 1)
+        {
+            held_ = data[cycleStart_];
+            position = positionOf(data, n, held_);
+            if (position != cycleStart_)
+            {
+                inCycle_ = true;
+            }
+            else
+            {
+                ++cycleStart_;
+            }
+        }
+
+        if (!inCycle_)
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+
+        // Put the held key in its place and pick up the one it displaces.
+        // The cycle closes when the key for cycleStart_ comes round.
+        while (position != cycleStart_)
+        {
+            metrics_.comparisons++;
+            if (data[position] != held_)
+            {
+                break;
+            }
+            ++position;
+        }
+        std::swap(held_, data[position]);
+        metrics_.writes++;
+        metrics_.swaps++;
+
+        if (position == cycleStart_)
+        {
+            inCycle_ = false;
+            ++cycleStart_;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    // cycleStart_ plus the number of keys after it smaller than key. Every
+    // position before cycleStart_ already holds its final key.
+    int positionOf(const int *data, int n, int key)
+    {
+        int smaller = 0;
+        for (int i = cycleStart_ + 1; i < n; ++i)
+        {
+            smaller += data[i] < key;
+        }
+        metrics_.comparisons += n - cycleStart_ - 1;
+        return cycleStart_ + smaller;
+    }
+
+    std::vector<int> *array_; // Pointer to the original array
+    int cycleStart_;          // Positions before this one are final
+    int held_;                // Key taken out of the array, waiting for its slot
+    bool inCycle_;
+};
@@ -0,0 +1,462 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include <vector>
+#include <stack>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+
+// Distribution sorts: a model of the keys' distribution maps every key to one
+// of m classes, non-decreasing in the key, so the classes are ordered and each
+// key goes straight to its class's region of the array. With m close to n/4
+// the classes of well-modelled data hold a handful of keys, which insertion
+// sort finishes in linear time. The model is the only difference between the
+// two sorts built here:
+//
+//   Flashsort      a straight line through the minimum and maximum key
+//                  (Neubert's Flashsort), exact for uniform keys
+//   Learned Sort   a piecewise-linear CDF fitted to a sorted sample, which
+//                  follows skewed keys as well (after Kristo et al.)
+//
+// Classes too large for insertion sort are distributed again with a model of
+// their own; after a few levels they are handed to quickSortRange(), so badly
+// modelled data costs O(n log n) at worst, never O(n^2).
+
+// Flashsort's classifier: class = m * (key - min) / (max - min + 1)
+struct LinearModel
+{
+    static constexpr const char *name = "Flashsort";
+
+    // Returns false if all keys are equal and the range is already sorted
+    template <typename Counters>
+    bool fit(const int *first, const int *last, int classes, Counters &counters)
+    {
+        auto [low, high] = std::minmax_element(first, last);
+        counters.comparisons += 3 * (last - first) / 2;
+        if (*low == *high)
+        {
+            return false;
+        }
+
+        // 32.32 fixed point; (max - min) * scale_ stays below classes << 32
+        low_ = static_cast<std::uint32_t>(*low);
+        std::uint64_t range = static_cast<std::uint64_t>(static_cast<std::uint32_t>(*high) - low_) + 1;
+        scale_ = (static_cast<std::uint64_t>(classes) << 32) / range;
+        return true;
+    }
+
+    template <typename Counters>
+    int classify(int key, Counters &) const
+    {
+        return static_cast<int>((static_cast<std::uint64_t>(static_cast<std::uint32_t>(key) - low_) * scale_) >> 32);
+    }
+
+    long long memoryBytes() const
+    {
+        return 0;
+    }
+
+private:
+    std::uint32_t low_ = 0;
+    std::uint64_t scale_ = 0;
+};
+
+// Learned Sort's classifier: the empirical CDF of a random sample, reduced to
+// one knot per samplesPerKnot samples with linear interpolation between them. A radix table over
+// the keys' high bits narrows the search for a key's segment to a few knots,
+// as in RadixSpline, so classifying a key costs O(1) for most distributions.
+struct CdfModel
+{
+    static constexpr const char *name = "Learned Sort";
+
+    template <typename Counters>
+    bool fit(const int *first, const int *last, int classes, Counters &counters)
+    {
+        // Within a class of the first pass the keys are close to uniform, and
+        // a straight line is cheaper to fit and to evaluate than a sample
+        linear_ = last - first < minCdfSize;
+        if (linear_)
+        {
+            return line_.fit(first, last, classes, counters);
+        }
+
+        classes_ = classes;
+        sampleKeys(first, last, counters);
+        fitKnots();
+        buildTable();
+        return true;
+    }
+
+    template <typename Counters>
+    int classify(int key, Counters &counters) const
+    {
+        if (linear_)
+        {
+            return line_.classify(key, counters);
+        }
+
+        // Keys outside the sampled range go to the first or last class
+        if (key <= lowKey_)
+        {
+            return 0;
+        }
+        std::uint32_t offset = static_cast<std::uint32_t>(key) - static_cast<std::uint32_t>(lowKey_);
+        if (offset >= offsets_.back())
+        {
+            return offset == offsets_.back() ? std::min(bases_.back(), classes_ - 1) : classes_ - 1;
+        }
+
+        // The last knot at or before the key: the table gives the first
+        // candidate, which usually is the one, and the next entry the last
+        std::uint32_t cell = offset >> shift_;
+        std::size_t knot = table_[cell];
+        counters.comparisons++;
+        if (offsets_[knot + 1] <= offset)
+        {
+            const std::uint32_t *candidatesEnd = offsets_.data() + table_[cell + 1] + 1;
+            knot = std::upper_bound(offsets_.data() + knot + 2, candidatesEnd, offset, [&counters](std::uint32_t a, std::uint32_t b)
+                                    {
+                                        counters.comparisons++;
+                                        return a < b; }) -
+                   offsets_.data() - 1;
+        }
+
+        return bases_[knot] + static_cast<int>((static_cast<std::uint64_t>(offset - offsets_[knot]) * slopes_[knot]) >> 32);
+    }
+
+    long long memoryBytes() const
+    {
+        return static_cast<long long>(sample_.capacity() * sizeof(int) + offsets_.capacity() * sizeof(std::uint32_t) +
+                                      bases_.capacity() * sizeof(int) + slopes_.capacity() * sizeof(std::uint64_t) +
+                                      table_.capacity() * sizeof(std::uint32_t));
+    }
+
+private:
+    static constexpr std::ptrdiff_t sampleRate = 100; // One key in 100 is sampled
+    static constexpr std::ptrdiff_t minSamples = 256;
+    static constexpr std::ptrdiff_t samplesPerKnot = 128; // Keeps the slopes' sampling error near 10%
+    static constexpr int maxKnots = 1024;
+    static constexpr std::uint32_t tableCells = 1 << 12; // Many per knot, so crowded knots stay apart
+    static constexpr std::ptrdiff_t minCdfSize = 1 << 16; // Smaller ranges are classified by a line
+
+    // Draw a random sample of the range and sort it
+    template <typename Counters>
+    void sampleKeys(const int *first, const int *last, Counters &counters)
+    {
+        std::ptrdiff_t size = last - first;
+        std::ptrdiff_t samples = std::min(size, std::max(minSamples, size / sampleRate));
+        sample_.resize(samples);
+
+        for (int &key : sample_)
+        {
+            // xorshift32, reseeded with the algorithm so runs are repeatable
+            state_ ^= state_ << 13;
+            state_ ^= state_ >> 17;
+            state_ ^= state_ << 5;
+            key = first[(static_cast<std::uint64_t>(state_) * static_cast<std::uint64_t>(size)) >> 32];
+        }
+
+        quickSortRange(sample_.data(), sample_.data() + samples, true, 2 * floorLog2(samples), counters);
+    }
+
+    // Evenly spaced quantiles of the sample become the knots; of a run of
+    // equal quantiles only the first is kept, so every key equal to it
+    // lands in one class
+    void fitKnots()
+    {
+        std::ptrdiff_t samples = static_cast<std::ptrdiff_t>(sample_.size());
+        int knots = static_cast<int>(std::clamp<std::ptrdiff_t>(samples / samplesPerKnot, 2, maxKnots));
+
+        lowKey_ = sample_.front();
+        offsets_.clear();
+        bases_.clear();
+        for (int i = 0; i < knots; ++i)
+        {
+            std::uint32_t offset = static_cast<std::uint32_t>(sample_[samples * i / knots]) - static_cast<std::uint32_t>(lowKey_);
+            if (!offsets_.empty() && offset == offsets_.back())
+            {
+                continue;
+            }
+            offsets_.push_back(offset);
+            bases_.push_back(static_cast<int>(static_cast<long long>(classes_) * i / knots));
+        }
+
+        // The sample maximum closes the last segment at the last class
+        std::uint32_t high = static_cast<std::uint32_t>(sample_.back()) - static_cast<std::uint32_t>(lowKey_);
+        if (high != offsets_.back())
+        {
+            offsets_.push_back(high);
+            bases_.push_back(classes_ - 1);
+        }
+
+        // Class increase per unit of key in each segment, 32.32 fixed point
+        // and rounded down, so no key reaches the next knot's class early
+        slopes_.assign(offsets_.size(), 0);
+        for (std::size_t k = 0; k + 1 < offsets_.size(); ++k)
+        {
+            slopes_[k] = (static_cast<std::uint64_t>(bases_[k + 1] - bases_[k]) << 32) / (offsets_[k + 1] - offsets_[k]);
+        }
+    }
+
+    // table_[cell] is the last knot at or before the cell's first key
+    void buildTable()
+    {
+        std::uint32_t span = offsets_.back();
+        shift_ = 0;
+        while ((span >> shift_) >= tableCells)
+        {
+            ++shift_;
+        }
+
+        std::uint32_t cells = (span >> shift_) + 1;
+        table_.resize(cells + 1);
+        std::uint32_t knot = 0;
+        for (std::uint32_t cell = 0; cell <= cells; ++cell)
+        {
+            std::uint64_t cellStart = static_cast<std::uint64_t>(cell) << shift_;
+            while (knot + 1 < offsets_.size() && offsets_[knot + 1] <= cellStart)
+            {
+                ++knot;
+            }
+            table_[cell] = knot;
+        }
+    }
+
+    std::vector<int> sample_;
+    std::vector<std::uint32_t> offsets_; // Knot keys minus lowKey_
+    std::vector<int> bases_;             // Class of each knot
+    std::vector<std::uint64_t> slopes_;  // Classes per key up to the next knot
+    std::vector<std::uint32_t> table_;
+    LinearModel line_;
+    bool linear_ = false;
+    int lowKey_ = 0; // Smallest sampled key
+    int shift_ = 0;
+    int classes_ = 2;
+    std::uint32_t state_ = 2463534242u;
+};
+
+// Each range takes three update() calls or more: fit the model and count the
+// classes, move every key to its class with a cycle-leader permutation, then
+// finish the classes a batch at a time
+template <typename Model>
+class DistributionSort final : public SteppedSortAlgorithm<DistributionSort<Model>>
+{
+    using Base = SteppedSortAlgorithm<DistributionSort<Model>>;
+    using Base::metrics_;
+
+public:
+    DistributionSort() : Base(Model::name) {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        tasks_ = std::stack<Range>();
+        model_ = Model();
+        step_ = Step::Next;
+
+        int n = static_cast<int>(array_->size());
+        if (n > 1)
+        {
+            tasks_.push({0, n, maxLevels});
+        }
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        switch (step_)
+        {
+        case Step::Next:
+            if (!tasks_.empty())
+            {
+                current_ = tasks_.top();
+                tasks_.pop();
+                countClasses();
+            }
+            break;
+
+        case Step::Permute:
+            permute();
+            nextClass_ = 0;
+            step_ = Step::Finish;
+            break;
+
+        case Step::Finish:
+            finishClasses();
+            break;
+        }
+
+        if (step_ == Step::Next && tasks_.empty())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    static constexpr int keysPerClass = 4;
+    static constexpr int maxClasses = 4096; // Keeps the class tables in cache; larger ranges take two passes
+    static_assert(maxClasses <= 65536, "classOf_ stores classes in 16 bits");
+    static constexpr int insertionThreshold = 32; // Larger classes are distributed again
+    static constexpr int baseCaseSize = 256;      // Ranges sorted by quickSortRange() outright
+    static constexpr int maxLevels = 4;
+    static constexpr int keysPerUpdate = 1 << 14; // Keys of finished classes per update()
+
+    enum class Step
+    {
+        Next,
+        Permute,
+        Finish
+    };
+
+    struct Range
+    {
+        int first;
+        int last;
+        int levels; // Distribution passes left before quickSortRange() takes over
+    };
+
+    // Fit the model to the current range and count the keys of every class
+    void countClasses()
+    {
+        int *data = array_->data();
+        int *first = data + current_.first;
+        int *last = data + current_.last;
+        int size = current_.last - current_.first;
+
+        if (size <= baseCaseSize || current_.levels == 0)
+        {
+            quickSortRange(first, last, first == data, 2 * floorLog2(size), metrics_);
+            return;
+        }
+
+        classes_ = std::max(2, std::min(maxClasses, size / keysPerClass));
+        if (!model_.fit(first, last, classes_, metrics_))
+        {
+            return;
+        }
+
+        // Each key's class is kept for the permutation, which then never
+        // waits on the model
+        WorkerCounters tally; // Kept local so the loop does not store to metrics_
+        classStart_.assign(classes_ + 1, 0);
+        classOf_.resize(std::max(classOf_.size(), static_cast<std::size_t>(size)));
+        for (int i = 0; i < size; ++i)
+        {
+            int c = model_.classify(first[i], tally);
+            classOf_[i] = static_cast<std::uint16_t>(c);
+            ++classStart_[c + 1];
+        }
+        metrics_.comparisons += tally.comparisons;
+
+        // A model that cannot tell the keys apart gains nothing
+        if (*std::max_element(classStart_.begin(), classStart_.end()) == size)
+        {
+            quickSortRange(first, last, first == data, 2 * floorLog2(size), metrics_);
+            return;
+        }
+
+        for (int c = 0; c < classes_; ++c)
+        {
+            classStart_[c + 1] += classStart_[c];
+        }
+        head_.assign(classStart_.begin(), classStart_.end() - 1);
+
+        metrics_.noteAuxMemory(static_cast<long long>((classStart_.capacity() + head_.capacity()) * sizeof(int) +
+                                                      classOf_.capacity() * sizeof(std::uint16_t)) +
+                               model_.memoryBytes());
+        step_ = Step::Permute;
+    }
+
+    // Cycle leader: the key at the next open slot of a class is carried to
+    // its own class, displacing the key there, until a key of the starting
+    // class turns up
+    void permute()
+    {
+        int *first = array_->data() + current_.first;
+        long long swaps = 0;
+        long long cycles = 0;
+
+        for (int c = 0; c < classes_; ++c)
+        {
+            while (head_[c] < classStart_[c + 1])
+            {
+                int value = first[head_[c]];
+                int target = classOf_[head_[c]];
+                while (target != c)
+                {
+                    // Slots below a class's head are final, so the class
+                    // recorded for the displaced key needs no update
+                    int slot = head_[target]++;
+                    std::swap(value, first[slot]);
+                    target = classOf_[slot];
+                    ++swaps;
+                }
+                first[head_[c]++] = value;
+                ++cycles;
+            }
+        }
+
+        metrics_.swaps += swaps;
+        metrics_.writes += swaps + cycles;
+    }
+
+    // Insertion sort the small classes and queue the large ones
+    void finishClasses()
+    {
+        int *first = array_->data() + current_.first;
+        int finished = 0;
+
+        while (nextClass_ < classes_ && finished < keysPerUpdate)
+        {
+            int begin = classStart_[nextClass_];
+            int end = classStart_[nextClass_ + 1];
+            ++nextClass_;
+
+            if (end - begin <= insertionThreshold)
+            {
+                insertionSort(first + begin, first + end, metrics_);
+            }
+            else
+            {
+                tasks_.push({current_.first + begin, current_.first + end, current_.levels - 1});
+            }
+            finished += end - begin;
+        }
+
+        if (nextClass_ == classes_)
+        {
+            step_ = Step::Next;
+        }
+    }
+
+    std::vector<int> *array_; // Pointer to the original array
+    std::stack<Range> tasks_;
+    Range current_ = {0, 0, 0};
+    Step step_ = Step::Next;
+    Model model_;
+    std::vector<int> classStart_; // Start of each class's region, relative to current_.first
+    std::vector<int> head_;       // Next open slot of each class
+    std::vector<std::uint16_t> classOf_; // Class of the key in each slot of the range
+    int classes_ = 0;
+    int nextClass_ = 0;
+};
+
+using FlashSort = DistributionSort<LinearModel>;
+using LearnedSort = DistributionSort<CdfModel>;
@@ -0,0 +1,247 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include "SortingNetworks.h"
+#include <vector>
+#include <stack>
+#include <algorithm>
+
+// Yaroslavskiy's dual-pivot Quick Sort, as in Java's Arrays.sort. Two pivots
+// taken from a sorted sample of five keys split each range into three parts
+// (< p, between, > q) in a single scan, so every key is visited fewer times
+// than with two rounds of single-pivot partitioning. When the pivots are
+// equal the range gets a three-way partition instead, and keys equal to a
+// pivot are moved out of an oversized middle part, so duplicates stay cheap.
+//
+// Like Quick Sort, each update() partitions the range on top of sortStack_;
+// a depth limit hands hopeless ranges to heapsort.
+class DualPivotQuickSort final : public SteppedSortAlgorithm<DualPivotQuickSort>
+{
+public:
+    DualPivotQuickSort() : SteppedSortAlgorithm("Dual-Pivot Quick Sort") {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        sortStack_ = std::stack<Range>();
+
+        int n = static_cast<int>(array_->size());
+        if (n > 1)
+        {
+            sortStack_.push({0, n, 2 * floorLog2(n)});
+        }
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning || sortStack_.empty())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+
+        // Get the next partition to process
+        Range range = sortStack_.top();
+        sortStack_.pop();
+
+        int *data = array_->data();
+        int *first = data + range.first;
+        int *last = data + range.last;
+
+        if (last - first <= networkSortThreshold)
+        {
+            networkSort(first, last, metrics_);
+        }
+        else if (range.depthLimit == 0)
+        {
+            heapSort(first, last, metrics_);
+        }
+        else
+        {
+            Parts parts = partition(first, last);
+            int depthLimit = range.depthLimit - 1;
+
+            // Push the largest part first so the smaller ones are sorted next
+            Range pending[3] = {
+                {range.first, static_cast<int>(parts.lessEnd - data), depthLimit},
+                {static_cast<int>(parts.middleFirst - data), static_cast<int>(parts.middleLast - data), depthLimit},
+                {static_cast<int>(parts.greaterFirst - data), range.last, depthLimit},
+            };
+            std::sort(pending, pending + 3, [](const Range &a, const Range &b)
+                      { return a.last - a.first > b.last - b.first; });
+            for (const Range &part : pending)
+            {
+                if (part.last - part.first > 1)
+                {
+                    sortStack_.push(part);
+                }
+            }
+        }
+
+        return !sortStack_.empty();
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    struct Range
+    {
+        int first;
+        int last;
+        int depthLimit;
+    };
+
+    // [first, lessEnd) < p, [middleFirst, middleLast) between the pivots and
+    // [greaterFirst, last) > q; the pivots and keys equal to them are done
+    struct Parts
+    {
+        int *lessEnd;
+        int *middleFirst;
+        int *middleLast;
+        int *greaterFirst;
+    };
+
+    static constexpr std::ptrdiff_t networkSortThreshold = 24;
+
+    Parts partition(int *first, int *last)
+    {
+        // Five keys spaced a seventh apart around the middle; the second and
+        // fourth smallest become the pivots, at the two ends of the range
+        std::ptrdiff_t seventh = (last - first) / 7;
+        int *samples[5];
+        samples[2] = first + (last - first) / 2;
+        samples[1] = samples[2] - seventh;
+        samples[0] = samples[1] - seventh;
+        samples[3] = samples[2] + seventh;
+        samples[4] = samples[3] + seventh;
+
+        int keys[5];
+        for (int i = 0; i < 5; ++i)
+        {
+            keys[i] = *samples[i];
+        }
+        networkSort(keys, keys + 5, metrics_);
+        for (int i = 0; i < 5; ++i)
+        {
+            *samples[i] = keys[i];
+        }
+
+        std::swap(*first, *samples[1]);
+        std::swap(*(last - 1), *samples[3]);
+        metrics_.swaps += 2;
+        metrics_.writes += 4;
+
+        int p = *first;
+        int q = *(last - 1);
+        if (p == q)
+        {
+            // A single pivot suffices: keys equal to it need no more work
+            auto [lessEnd, greaterFirst] = partitionThreeWay(first, last, metrics_);
+            return {lessEnd, greaterFirst, greaterFirst, greaterFirst};
+        }
+
+        int *less = first + 1;  // End of the keys < p
+        int *great = last - 2;  // Start of the keys > q, minus one
+        for (int *k = less; k <= great; ++k)
+        {
+            metrics_.comparisons++;
+            if (*k < p)
+            {
+                std::swap(*k, *less++);
+                metrics_.swaps++;
+                metrics_.writes += 2;
+                continue;
+            }
+
+            metrics_.comparisons++;
+            if (q < *k)
+            {
+                // Skip the keys > q already at the right end
+                while (k < great && q < *great)
+                {
+                    metrics_.comparisons++;
+                    --great;
+                }
+                metrics_.comparisons++;
+
+                std::swap(*k, *great--);
+                metrics_.swaps++;
+                metrics_.writes += 2;
+
+                // The key fetched from the right may belong on the left
+                metrics_.comparisons++;
+                if (*k < p)
+                {
+                    std::swap(*k, *less++);
+                    metrics_.swaps++;
+                    metrics_.writes += 2;
+                }
+            }
+        }
+
+        // Put the pivots between the parts
+        --less;
+        ++great;
+        std::swap(*first, *less);
+        std::swap(*(last - 1), *great);
+        metrics_.swaps += 2;
+        metrics_.writes += 4;
+
+        Parts parts = {less, less + 1, great, great + 1};
+
+        // A middle part spanning the outer samples means the pivots are
+        // probably repeated many times: gather the keys equal to them at its
+        // ends, where they are already in place
+        if (parts.middleFirst < samples[0] && samples[4] < parts.middleLast)
+        {
+            gatherPivotKeys(parts, p, q);
+        }
+        return parts;
+    }
+
+    // Three-way split of the middle part into == p, between and == q
+    void gatherPivotKeys(Parts &parts, int p, int q)
+    {
+        int *equalP = parts.middleFirst;
+        int *k = parts.middleFirst;
+        int *equalQ = parts.middleLast;
+
+        while (k < equalQ)
+        {
+            metrics_.comparisons++;
+            if (*k == p)
+            {
+                std::swap(*equalP++, *k++);
+                metrics_.swaps++;
+                metrics_.writes += 2;
+                continue;
+            }
+
+            metrics_.comparisons++;
+            if (*k == q)
+            {
+                std::swap(*k, *--equalQ);
+                metrics_.swaps++;
+                metrics_.writes += 2;
+            }
+            else
+            {
+                ++k;
+            }
+        }
+
+        parts.middleFirst = equalP;
+        parts.middleLast = equalQ;
+    }
+
+    std::vector<int> *array_; // Pointer to the original array
+    std::stack<Range> sortStack_;
+};
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include <vector>
+
+// Heapsort with Floyd's bottom-up sift-down on a 4-ary heap whose sibling
+// groups are aligned to 16 bytes, so each level of a sift-down touches one
+// cache line. O(n log n) in the worst case with O(1) extra memory; the same
+// kernels are the introsort fallback. Each update() sifts one node while the
+// heap is built, then moves one key to its final place.
+class HeapSort final : public SteppedSortAlgorithm<HeapSort>
+{
+public:
+    HeapSort() : SteppedSortAlgorithm("Heap Sort") {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+
+        int *first = array_->data();
+        int *last = first + array_->size();
+        heapStart_ = static_cast<int>(alignedHeapStart(first, last) - first);
+        heapEnd_ = static_cast<int>(array_->size());
+        int size = heapEnd_ - heapStart_;
+        nextNode_ = size > 1 ? (size - 2) / static_cast<int>(heapArity) : -1;
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        int *first = array_->data();
+        int *heap = first + heapStart_;
+
+        if (nextNode_ >= 0)
+        {
+            // Build the heap from the last internal node up
+            siftDown(heap, nextNode_, heapEnd_ - heapStart_, metrics_);
+            --nextNode_;
+            return true;
+        }
+
+        if (heapEnd_ - heapStart_ > 1)
+        {
+            popHeap(heap, first + heapEnd_, metrics_);
+            --heapEnd_;
+            return true;
+        }
+
+        finishHeapSort(first, heap, first + array_->size(), metrics_);
+        metrics_.isRunning = false;
+        return false;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    std::vector<int> *array_; // Pointer to the original array
+    int heapStart_ = 0;       // Keys before it are merged in at the end
+    int heapEnd_ = 0;
+    int nextNode_ = -1; // Next node to sift while building, -1 once built
+};
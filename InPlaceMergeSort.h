@@ -0,0 +1,295 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include <vector>
+#include <algorithm>
+
+// Stable bottom-up merge sort that needs no O(n) scratch space. Blocks of
+// baseBlockSize keys are insertion sorted, then runs are merged in place. The
+// keys already in position at either end of a merge are trimmed off by binary
+// search; when the shorter of the remaining runs fits the fixed internal
+// buffer, it is moved there and merged back. Longer merges are split the way
+// std::inplace_merge does without memory: the longer run is cut in half, the
+// cut is located in the other run and a rotation leaves two smaller merges.
+// Ties always go to the left run, so equal keys keep their order.
+//
+// Merges too long for the buffer add O(log n) levels of rotations, so the
+// worst case is O(n log^2 n), but most of the splitting stops after a few
+// levels. Each update() sorts a group of blocks or performs one merge.
+class InPlaceMergeSort final : public SteppedSortAlgorithm<InPlaceMergeSort>
+{
+public:
+    InPlaceMergeSort() : SteppedSortAlgorithm("In-Place Merge Sort"), currentSize_(0), leftStart_(0) {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        currentSize_ = 0;
+        leftStart_ = 0;
+
+        metrics_.resetMetrics();
+        metrics_.noteAuxMemory(static_cast<long long>(sizeof(buffer_) + sizeof(pending_)));
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        int n = static_cast<int>(array_->size());
+        int *data = array_->data();
+
+        if (currentSize_ == 0)
+        {
+            // Sort the next group of blocks
+            int end = std::min(leftStart_ + baseBlockSize * blocksPerUpdate, n);
+            for (int block = leftStart_; block < end; block += baseBlockSize)
+            {
+                insertionSort(data + block, data + std::min(block + baseBlockSize, end), metrics_);
+            }
+
+            leftStart_ = end;
+            if (leftStart_ >= n)
+            {
+                currentSize_ = baseBlockSize;
+                leftStart_ = 0;
+            }
+        }
+        else if (currentSize_ < n)
+        {
+            int mid = std::min(leftStart_ + currentSize_, n);
+            int right = std::min(leftStart_ + 2 * currentSize_, n);
+
+            mergeRuns(data + leftStart_, data + mid, data + right);
+            leftStart_ += 2 * currentSize_;
+
+            if (leftStart_ >= n)
+            {
+                currentSize_ = 2 * currentSize_;
+                leftStart_ = 0;
+            }
+        }
+
+        if (currentSize_ >= n)
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    static const int baseBlockSize = 32;
+    static const int blocksPerUpdate = 16;
+    static const int bufferSize = 512; // Keys; 2 KB stays in L1 with the keys being merged
+
+    // A merge of [first, middle) and [middle, last) waiting its turn
+    struct Merge
+    {
+        int *first;
+        int *middle;
+        int *last;
+    };
+
+    // Merges split off are at most half the size of the one they came from,
+    // so the stack is never deeper than log2(n) <= 31
+    static const int maxPending = 32;
+
+    // Merge the sorted runs [first, middle) and [middle, last) in place. The
+    // smaller half of every split is merged first and the larger one waits
+    // on the fixed stack.
+    void mergeRuns(int *first, int *middle, int *last)
+    {
+        int pending = 0;
+
+        while (true)
+        {
+            trim(first, middle, last);
+
+            if (first == middle || middle == last)
+            {
+                // Nothing left to merge
+            }
+            else if (middle - first <= bufferSize)
+            {
+                mergeForward(first, middle, last);
+            }
+            else if (last - middle <= bufferSize)
+            {
+                mergeBackward(first, middle, last);
+            }
+            else
+            {
+                int *leftCut;
+                int *rightCut;
+                if (middle - first >= last - middle)
+                {
+                    leftCut = first + (middle - first) / 2;
+                    rightCut = lowerBound(middle, last, *leftCut);
+                }
+                else
+                {
+                    rightCut = middle + (last - middle) / 2;
+                    leftCut = upperBound(first, middle, *rightCut);
+                }
+
+                // [leftCut, middle) and [middle, rightCut) trade places
+                int *newMiddle = rotateBlocks(leftCut, middle, rightCut);
+
+                Merge left = {first, leftCut, newMiddle};
+                Merge right = {newMiddle, rightCut, last};
+                if (left.last - left.first < right.last - right.first)
+                {
+                    std::swap(left, right);
+                }
+                pending_[pending++] = left;
+
+                first = right.first;
+                middle = right.middle;
+                last = right.last;
+                continue;
+            }
+
+            if (pending == 0)
+            {
+                return;
+            }
+
+            const Merge &next = pending_[--pending];
+            first = next.first;
+            middle = next.middle;
+            last = next.last;
+        }
+    }
+
+    // Drop the keys that are already in place: the left run's keys no greater
+    // than the right run's first key, and the right run's keys no smaller than
+    // the left run's last key. Afterwards both runs are empty or the left run
+    // starts and ends with keys greater than those of the right run.
+    void trim(int *&first, int *middle, int *&last)
+    {
+        if (first == middle || middle == last)
+        {
+            return;
+        }
+
+        metrics_.comparisons++;
+        if (!(*middle < *(middle - 1)))
+        {
+            // Already in order, as runs of presorted input usually are
+            first = middle;
+            return;
+        }
+
+        first = upperBound(first, middle, *middle);
+        last = lowerBound(middle, last, *(middle - 1));
+    }
+
+    // Buffer the left run and merge from the front. The right run runs out
+    // first, since its keys are all smaller than the left run's last one, and
+    // the merged output never catches up with the unread part of it.
+    void mergeForward(int *first, int *middle, int *last)
+    {
+        int *bufferEnd = std::copy(first, middle, buffer_);
+        const int *a = buffer_;
+        const int *b = middle;
+        int *out = first;
+
+        while (b < last)
+        {
+            bool takeRight = *b < *a;
+            *out++ = takeRight ? *b : *a;
+            b += takeRight;
+            a += !takeRight;
+        }
+        std::copy(a, static_cast<const int *>(bufferEnd), out);
+
+        metrics_.comparisons += (b - middle) + (a - buffer_);
+        metrics_.swaps += last - middle;
+        metrics_.writes += (middle - first) + (last - first);
+    }
+
+    // Buffer the right run and merge from the back, taking the right run's
+    // key on ties. The left run runs out first.
+    void mergeBackward(int *first, int *middle, int *last)
+    {
+        int *bufferEnd = std::copy(middle, last, buffer_);
+        const int *a = middle;
+        const int *b = bufferEnd;
+        int *out = last;
+
+        while (a > first)
+        {
+            bool takeLeft = *(b - 1) < *(a - 1);
+            *--out = takeLeft ? *(a - 1) : *(b - 1);
+            a -= takeLeft;
+            b -= !takeLeft;
+        }
+        std::copy(static_cast<const int *>(buffer_), b, first);
+
+        metrics_.comparisons += (middle - a) + (bufferEnd - b);
+        metrics_.swaps += last - middle;
+        metrics_.writes += (last - middle) + (last - first);
+    }
+
+    // Exchange the adjacent blocks [first, middle) and [middle, last) and
+    // return where the first one now starts. The smaller block goes through
+    // the buffer when it fits, so the other one moves with a single copy.
+    int *rotateBlocks(int *first, int *middle, int *last)
+    {
+        std::ptrdiff_t left = middle - first;
+        std::ptrdiff_t right = last - middle;
+        metrics_.swaps += right;
+        metrics_.writes += left + right;
+
+        if (left <= right && left <= bufferSize)
+        {
+            std::copy(first, middle, buffer_);
+            std::copy(middle, last, first);
+            std::copy(buffer_, buffer_ + left, last - left);
+            metrics_.writes += left;
+            return last - left;
+        }
+        if (right <= bufferSize)
+        {
+            std::copy(middle, last, buffer_);
+            std::copy_backward(first, middle, last);
+            std::copy(buffer_, buffer_ + right, first);
+            metrics_.writes += right;
+            return first + right;
+        }
+        return std::rotate(first, middle, last);
+    }
+
+    int *lowerBound(int *first, int *last, int key)
+    {
+        return std::lower_bound(first, last, key, [this](int a, int b)
+                                {
+                                    metrics_.comparisons++;
+                                    return a < b; });
+    }
+
+    int *upperBound(int *first, int *last, int key)
+    {
+        return std::upper_bound(first, last, key, [this](int a, int b)
+                                {
+                                    metrics_.comparisons++;
+                                    return a < b; });
+    }
+
+    std::vector<int> *array_; // Pointer to the original array
+    int buffer_[bufferSize];  // The only scratch space besides pending_
+    Merge pending_[maxPending];
+    int currentSize_;
+    int leftStart_;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include <vector>
+#include <stack>
+
+// Quick Sort hardened against bad inputs: median-of-three / ninther pivots,
+// insertion sort for small partitions and a heapsort fallback once the
+// recursion gets too deep. One partition is processed per update().
+class IntroSort final : public SteppedSortAlgorithm<IntroSort>
+{
+public:
+    IntroSort() : SteppedSortAlgorithm("Intro Sort") {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        sortStack_ = std::stack<Partition>();
+
+        if (!array_->empty())
+        {
+            int n = static_cast<int>(array_->size());
+            sortStack_.push({0, n - 1, 2 * floorLog2(n)});
+        }
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning || sortStack_.empty())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+
+        // Get the next partition to process
+        Partition top = sortStack_.top();
+        sortStack_.pop();
+
+        int *first = array_->data() + top.low;
+        int *last = array_->data() + top.high + 1;
+
+        if (last - first <= insertionSortThreshold)
+        {
+            insertionSort(first, last, metrics_);
+        }
+        else if (top.depthLimit == 0)
+        {
+            // Too many unbalanced partitions: finish this range in O(n log n)
+            heapSort(first, last, metrics_);
+        }
+        else
+        {
+            selectPivotToFront(first, last, metrics_);
+            int pivot = static_cast<int>(partitionAroundFront(first, last, metrics_) - array_->data());
+
+            // Push the larger side first so the smaller one is processed next,
+            // which keeps the stack depth at O(log n)
+            Partition left = {top.low, pivot - 1, top.depthLimit - 1};
+            Partition right = {pivot + 1, top.high, top.depthLimit - 1};
+            if (pivot - top.low < top.high - pivot)
+            {
+                std::swap(left, right);
+            }
+            sortStack_.push(left);
+            sortStack_.push(right);
+        }
+
+        return !sortStack_.empty();
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    struct Partition
+    {
+        int low;
+        int high;
+        int depthLimit;
+    };
+
+    static const int insertionSortThreshold = 16;
+
+    std::vector<int> *array_; // Pointer to the original array
+    std::stack<Partition> sortStack_;
+};
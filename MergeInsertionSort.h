@@ -0,0 +1,254 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include <vector>
+#include <algorithm>
+
+// Ford-Johnson merge-insertion sort, which needs fewer comparisons than any
+// other practical sort: about n log2 n - 1.415n against the log2(n!) floor of
+// n log2 n - 1.443n. The keys are paired and each pair compared once, the
+// larger keys a_1..a_m are sorted recursively, and the main chain starts as
+// b_1 a_1 .. a_m, where b_j is the partner of a_j. The other b_j are binary
+// inserted in groups that end at the Jacobsthal numbers 3, 5, 11, 21, 43...,
+// each group from its highest j down. Since b_j < a_j, b_j only searches the
+// chain up to a_j, and the group bounds keep that prefix just below a power
+// of two long, so no comparison of a search is wasted.
+//
+// The comparisons are what it saves; moving keys into the chain is O(n^2),
+// as in binary insertion. The first update() pairs the keys and sorts the
+// larger ones, then each update() inserts one of the smaller keys into the
+// chain at the front of the array.
+class MergeInsertionSort final : public SteppedSortAlgorithm<MergeInsertionSort>
+{
+public:
+    MergeInsertionSort() : SteppedSortAlgorithm("Merge-Insertion Sort"), prepared_(false), liveBytes_(0) {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        prepared_ = false;
+        liveBytes_ = 0;
+        top_ = Chain();
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        if (!prepared_)
+        {
+            prepare();
+            prepared_ = true;
+        }
+        else if (top_.next < top_.plan.size())
+        {
+            // Insert the next pending key, mirroring the chain in the array
+            size_t from = top_.size;
+            size_t position = insertNext(top_);
+            int *data = array_->data();
+            std::copy_backward(data + position, data + from, data + from + 1);
+            data[position] = keys_[top_.ids[position]];
+            metrics_.writes += static_cast<long long>(from - position) + 1;
+            metrics_.swaps++;
+        }
+
+        if (top_.next >= top_.plan.size())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    // A key b_j waiting to be inserted into the main chain. The first key of
+    // each group also carries the chain index of a_j when the group starts.
+    struct Pending
+    {
+        int j;
+        int bound;
+    };
+
+    // Key ids laid out as the main chain followed by the pending keys in
+    // insertion order, so the next key to insert is always ids[size]
+    struct Chain
+    {
+        std::vector<int> ids;
+        std::vector<int> larger; // a_1..a_m in sorted order
+        std::vector<Pending> plan;
+        size_t size = 0;     // Length of the main chain
+        size_t next = 0;     // Next entry of plan
+        size_t boundary = 0; // Chain index of a_j for the next key b_j
+    };
+
+    // Pair the keys and sort the larger ones, then lay the array out as the
+    // main chain followed by the keys still to insert
+    void prepare()
+    {
+        keys_ = *array_;
+        partnerOf_.assign(keys_.size(), 0);
+        liveBytes_ = static_cast<long long>(keys_.size() * sizeof(int) * 2);
+
+        std::vector<int> ids(keys_.size());
+        for (size_t i = 0; i < ids.size(); ++i)
+        {
+            ids[i] = static_cast<int>(i);
+        }
+        buildChain(ids, top_);
+
+        int *data = array_->data();
+        for (size_t i = 0; i < top_.ids.size(); ++i)
+        {
+            data[i] = keys_[top_.ids[i]];
+        }
+        metrics_.writes += static_cast<long long>(top_.ids.size());
+    }
+
+    // Sort ids by key
+    void sortIds(std::vector<int> &ids)
+    {
+        if (ids.size() < 2)
+        {
+            return;
+        }
+
+        Chain chain;
+        buildChain(ids, chain);
+        while (chain.next < chain.plan.size())
+        {
+            insertNext(chain);
+        }
+        ids.swap(chain.ids);
+        liveBytes_ -= chainBytes(chain);
+    }
+
+    void buildChain(const std::vector<int> &ids, Chain &chain)
+    {
+        size_t pairs = ids.size() / 2;
+        bool straggler = ids.size() % 2 != 0;
+        if (pairs == 0)
+        {
+            chain.ids = ids;
+            chain.size = ids.size();
+            return;
+        }
+
+        // One comparison per pair. partnerOf_ is filled in only after the
+        // deeper levels, which reuse it for their own pairs, have returned.
+        std::vector<int> smaller(pairs);
+        chain.larger.resize(pairs);
+        for (size_t i = 0; i < pairs; ++i)
+        {
+            int a = ids[2 * i];
+            int b = ids[2 * i + 1];
+            metrics_.comparisons++;
+            if (keys_[a] < keys_[b])
+            {
+                std::swap(a, b);
+            }
+            chain.larger[i] = a;
+            smaller[i] = b;
+        }
+
+        std::vector<int> unsorted = chain.larger;
+        sortIds(chain.larger);
+        for (size_t i = 0; i < pairs; ++i)
+        {
+            partnerOf_[unsorted[i]] = smaller[i];
+        }
+
+        int m = static_cast<int>(pairs);
+        int last = m + (straggler ? 1 : 0);
+
+        // Groups end at the Jacobsthal numbers t_k = t_(k-1) + 2 t_(k-2). When
+        // a group starts, the chain holds b_1..b_previous and every a, so a_j
+        // sits at index previous + j - 1 (the chain's end for the straggler).
+        int previous = 1;
+        int current = 3;
+        while (previous < last)
+        {
+            int high = std::min(current, last);
+            for (int j = high; j > previous; --j)
+            {
+                chain.plan.push_back({j, j == high ? previous + j - 1 : -1});
+            }
+            int following = current + 2 * previous;
+            previous = current;
+            current = following;
+        }
+
+        chain.ids.reserve(ids.size());
+        chain.ids.push_back(partnerOf_[chain.larger[0]]);
+        chain.ids.insert(chain.ids.end(), chain.larger.begin(), chain.larger.end());
+        chain.size = chain.ids.size();
+        for (const Pending &pending : chain.plan)
+        {
+            chain.ids.push_back(pending.j <= m ? partnerOf_[chain.larger[pending.j - 1]] : ids.back());
+        }
+
+        liveBytes_ += chainBytes(chain);
+        metrics_.noteAuxMemory(liveBytes_);
+    }
+
+    // Binary insert ids[size] into the chain below a_j and return its index
+    size_t insertNext(Chain &chain)
+    {
+        const Pending &pending = chain.plan[chain.next];
+        if (pending.bound >= 0)
+        {
+            chain.boundary = static_cast<size_t>(pending.bound);
+        }
+
+        int *ids = chain.ids.data();
+        int id = ids[chain.size];
+        int key = keys_[id];
+        int *position = std::upper_bound(ids, ids + chain.boundary, key, [this](int value, int other)
+                                         {
+                                             metrics_.comparisons++;
+                                             return value < keys_[other]; });
+        std::copy_backward(position, ids + chain.size, ids + chain.size + 1);
+        *position = id;
+        chain.size++;
+        chain.next++;
+
+        // a_j moved up by one. Between a_(j-1) and a_j there are only keys of
+        // this group, so walking back to a_(j-1) costs O(1) amortized.
+        if (chain.next < chain.plan.size() && chain.plan[chain.next].bound < 0)
+        {
+            size_t index = chain.boundary;
+            int target = chain.larger[chain.plan[chain.next].j - 1];
+            while (ids[index] != target)
+            {
+                --index;
+            }
+            chain.boundary = index;
+        }
+
+        return static_cast<size_t>(position - ids);
+    }
+
+    static long long chainBytes(const Chain &chain)
+    {
+        return static_cast<long long>(chain.ids.capacity() * sizeof(int) + chain.larger.capacity() * sizeof(int) +
+                                      chain.plan.capacity() * sizeof(Pending));
+    }
+
+    std::vector<int> *array_; // Pointer to the original array
+    std::vector<int> keys_;   // The keys by id, as they were when the sort started
+    std::vector<int> partnerOf_;
+    Chain top_;
+    bool prepared_;
+    long long liveBytes_;
+};
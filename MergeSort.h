@@ -1,20 +1,42 @@
 #pragma once
 
 #include "SortAlgorithm.h"
+#include "SortingNetworks.h"
+#include "SimdMerge.h"
 #include <vector>
 #include <algorithm>
 
-class MergeSort : public SortAlgorithm
+// Bottom-up merge sort. The first pass sorts blocks of baseBlockSize keys with
+// sorting networks, a group of blocks per update(); every later pass merges
+// runs with the SIMD merge kernel from one buffer into the other and the roles
+// swap between passes, so nothing is ever copied back and update() never
+// allocates. The blocks are sorted into whichever buffer makes the last pass
+// land in the original array.
+class MergeSort final : public SteppedSortAlgorithm<MergeSort>
 {
 public:
-    MergeSort() : SortAlgorithm("Merge Sort"), currentSize_(1), leftStart_(0) {}
+    MergeSort() : SteppedSortAlgorithm("Merge Sort"), currentSize_(0), leftStart_(0) {}
 
     void initialize(std::vector<int> &array) override
     {
         array_ = &array; // Store a reference to the original array
-        currentSize_ = 1;
+        currentSize_ = 0;
         leftStart_ = 0;
+
+        // Scratch buffer is only reallocated when the array grows
+        buffer_.resize(array_->size());
+
+        int passes = 0;
+        for (size_t width = baseBlockSize; width < array_->size(); width *= 2)
+        {
+            ++passes;
+        }
+
+        source_ = (passes % 2) ? buffer_.data() : array_->data();
+        dest_ = (passes % 2) ? array_->data() : buffer_.data();
+
         metrics_.resetMetrics();
+        metrics_.noteAuxMemory(static_cast<long long>(buffer_.size() * sizeof(int)));
         metrics_.isRunning = true;
         metrics_.startTimer();
     }
@@ -26,26 +48,39 @@ public:
             return false;
         }
 
-        int n = array_->size();
+        int n = static_cast<int>(array_->size());
 
-        if (leftStart_ >= n - 1)
+        if (currentSize_ == 0)
         {
-            if (currentSize_ > n - 1)
+            sortBlocks(n);
+            if (leftStart_ >= n)
             {
-                metrics_.isRunning = false;
-                return false;
+                currentSize_ = baseBlockSize;
+                leftStart_ = 0;
             }
-
-            currentSize_ = 2 * currentSize_;
-            leftStart_ = 0;
         }
+        else if (currentSize_ < n)
+        {
+            int mid = std::min(leftStart_ + currentSize_, n);
+            int right = std::min(leftStart_ + 2 * currentSize_, n);
 
-        int mid = std::min(leftStart_ + currentSize_ - 1, n - 1);
-        int right = std::min(leftStart_ + 2 * currentSize_ - 1, n - 1);
+            performMerge(leftStart_, mid, right);
+            leftStart_ += 2 * currentSize_;
 
-        performMerge(leftStart_, mid, right);
-        leftStart_ += 2 * currentSize_;
+            // End of a pass: the destination becomes the next source
+            if (leftStart_ >= n)
+            {
+                currentSize_ = 2 * currentSize_;
+                leftStart_ = 0;
+                std::swap(source_, dest_);
+            }
+        }
 
+        if (currentSize_ >= n)
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
         return true;
     }
 
@@ -55,61 +90,49 @@ public:
     }
 
 private:
-    void performMerge(int left, int mid, int right)
-    {
-        int n1 = mid - left + 1;
-        int n2 = right - mid;
+    static const int baseBlockSize = 32;
+    static const int blocksPerUpdate = 16; // One block per lane of a 16-key vector
 
-        // Create temporary arrays
-        std::vector<int> L(n1), R(n2);
+    // Sort the next group of blocks into source_
+    void sortBlocks(int n)
+    {
+        int begin = leftStart_;
+        int end = std::min(begin + baseBlockSize * blocksPerUpdate, n);
+        leftStart_ = end;
 
-        for (int i = 0; i < n1; i++)
-        {
-            L[i] = (*array_)[left + i];
-        }
-        for (int j = 0; j < n2; j++)
+        if (source_ != array_->data())
         {
-            R[j] = (*array_)[mid + 1 + j];
+            std::copy(array_->data() + begin, array_->data() + end, source_ + begin);
+            metrics_.writes += end - begin;
         }
 
-        // Merge the temporary arrays back into the original array
-        int i = 0;
-        int j = 0;
-        int k = left;
+        int blocks = (end - begin) / baseBlockSize;
+        int *first = source_ + begin;
+        networkSortBatch(first, blocks, baseBlockSize);
+        metrics_.comparisons += static_cast<long long>(blocks) * SortingNetwork<baseBlockSize>::count;
+        metrics_.writes += static_cast<long long>(blocks) * baseBlockSize;
 
-        while (i < n1 && j < n2)
-        {
-            metrics_.comparisons++;
-            if (L[i] <= R[j])
-            {
-                (*array_)[k] = L[i];
-                i++;
-            }
-            else
-            {
-                (*array_)[k] = R[j];
-                j++;
-                metrics_.swaps++;
-            }
-            k++;
-        }
+        // A short last block
+        networkSort(first + blocks * baseBlockSize, source_ + end, metrics_);
+    }
 
-        while (i < n1)
-        {
-            (*array_)[k] = L[i];
-            i++;
-            k++;
-        }
+    // Merge source_[left, mid) and source_[mid, right) into dest_[left, right)
+    // with the vector merge kernel (a lone trailing run is just carried across)
+    void performMerge(int left, int mid, int right)
+    {
+        const int *src = source_;
+        mergeSorted(src + left, src + mid, src + mid, src + right, dest_ + left);
 
-        while (j < n2)
-        {
-            (*array_)[k] = R[j];
-            j++;
-            k++;
-        }
+        MergeCount count = countMerge(src + left, src + mid, src + mid, src + right);
+        metrics_.comparisons += count.comparisons;
+        metrics_.swaps += count.fromSecond;
+        metrics_.writes += right - left;
     }
 
     std::vector<int> *array_; // Pointer to the original array
+    std::vector<int> buffer_; // Persistent scratch space, the other half of the ping-pong
+    int *source_ = nullptr;
+    int *dest_ = nullptr;
     int currentSize_;
     int leftStart_;
-};
\ No newline at end of file
+};
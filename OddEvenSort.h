@@ -0,0 +1,118 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortingNetworks.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+// Odd-even transposition sort, the parallel form of Bubble Sort: even phases
+// compare-exchange the pairs (0, 1), (2, 3), ..., odd phases (1, 2), (3, 4), ...
+// No two exchanges of a phase touch the same key, so each phase runs 8 or 16
+// pairs per vector instruction and is split across the shared thread pool,
+// whose join is the barrier between phases. Each update() performs one phase;
+// the array is sorted after n phases, or as soon as an even and an odd phase
+// in a row find nothing to exchange.
+class OddEvenSort final : public SteppedSortAlgorithm<OddEvenSort>
+{
+public:
+    OddEvenSort() : SteppedSortAlgorithm("Odd-Even Sort"), pool_(ThreadPool::getShared()) {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        workers_.assign(pool_.getThreadCount(), WorkerCounters());
+        phase_ = 0;
+        quietPhases_ = 0;
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        int n = static_cast<int>(array_->size());
+        if (!metrics_.isRunning || phase_ >= n || quietPhases_ >= 2)
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+
+        // Odd phases start one key later
+        int *first = array_->data() + phase_ % 2;
+        int *last = array_->data() + n;
+        long long exchanged = n >= parallelThreshold && pool_.getThreadCount() > 1
+                                  ? runPhaseParallel(first, last)
+                                  : runPhase(first, last, metrics_);
+
+        quietPhases_ = exchanged == 0 ? quietPhases_ + 1 : 0;
+        ++phase_;
+
+        if (phase_ >= n || quietPhases_ >= 2)
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    static const int parallelThreshold = 1 << 15;
+
+    using Clock = std::chrono::steady_clock;
+
+    template <typename Counters>
+    static long long runPhase(int *first, int *last, Counters &counters)
+    {
+        long long exchanged = transpositionPhase(first, last);
+        counters.comparisons += (last - first) / 2;
+        counters.swaps += exchanged;
+        counters.writes += 2 * exchanged;
+        return exchanged;
+    }
+
+    // One slice of pairs per worker
+    long long runPhaseParallel(int *first, int *last)
+    {
+        int tasks = pool_.getThreadCount();
+        long long pairs = (last - first) / 2;
+
+        for (auto &counters : workers_)
+        {
+            counters = WorkerCounters();
+        }
+
+        pool_.parallelFor(tasks, [&](int task, int worker)
+                          {
+            WorkerCounters &counters = workers_[worker];
+            auto start = Clock::now();
+
+            // Slices start on a pair so no pair is split between workers
+            int *sliceFirst = first + 2 * (pairs * task / tasks);
+            int *sliceLast = task + 1 == tasks ? last : first + 2 * (pairs * (task + 1) / tasks);
+            runPhase(sliceFirst, sliceLast, counters);
+            counters.elements += sliceLast - sliceFirst;
+            counters.busyTime += std::chrono::duration<double>(Clock::now() - start).count(); });
+
+        long long exchanged = 0;
+        for (const auto &counters : workers_)
+        {
+            exchanged += counters.swaps;
+        }
+        metrics_.addWorkerCounters(workers_);
+        return exchanged;
+    }
+
+    ThreadPool &pool_;
+    std::vector<int> *array_; // Pointer to the original array
+    std::vector<WorkerCounters> workers_;
+    int phase_ = 0;
+    int quietPhases_ = 0; // Phases in a row without an exchange
+};
@@ -0,0 +1,215 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include "ThreadPool.h"
+#include "SimdMerge.h"
+#include <vector>
+#include <algorithm>
+#include <chrono>
+
+// Bottom-up merge sort spread over the shared thread pool. Every merge level
+// is cut into equal slices of output using merge-path (co-rank) partitioning,
+// so each worker merges the same number of elements even when only one or two
+// huge runs are left, and each slice goes through the SIMD merge kernel. Like
+// Merge Sort it ping-pongs between the array and a persistent scratch buffer.
+// The first update() sorts small blocks with sorting networks, then each
+// update() performs one complete merge level.
+class ParallelMergeSort final : public SteppedSortAlgorithm<ParallelMergeSort>
+{
+public:
+    ParallelMergeSort() : SteppedSortAlgorithm("Parallel Merge Sort"), pool_(ThreadPool::getShared()) {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        buffer_.resize(array_->size());
+        workers_.assign(pool_.getThreadCount(), WorkerCounters());
+        currentSize_ = 0;
+
+        // Sort the blocks into whichever buffer makes the final level land in the array
+        int levels = 0;
+        for (size_t width = baseBlockSize; width < array_->size(); width *= 2)
+        {
+            ++levels;
+        }
+        source_ = (levels % 2) ? buffer_.data() : array_->data();
+        dest_ = (levels % 2) ? array_->data() : buffer_.data();
+
+        metrics_.resetMetrics();
+        metrics_.noteAuxMemory(static_cast<long long>(buffer_.size() * sizeof(int)));
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        int n = static_cast<int>(array_->size());
+
+        if (currentSize_ == 0)
+        {
+            sortBaseBlocks(n);
+            currentSize_ = baseBlockSize;
+        }
+        else if (currentSize_ < n)
+        {
+            mergeLevel(n);
+            std::swap(source_, dest_);
+            currentSize_ *= 2;
+        }
+
+        if (currentSize_ >= n)
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    static const int baseBlockSize = 32;
+    static const int slicesPerWorker = 4; // Extra slices smooth out uneven thread speeds
+
+    using Clock = std::chrono::steady_clock;
+
+    // Sort blocks of baseBlockSize elements into source_ with sorting networks
+    void sortBaseBlocks(int n)
+    {
+        const int *input = array_->data();
+        int *output = source_;
+        int blocks = (n + baseBlockSize - 1) / baseBlockSize;
+        int tasks = std::min(blocks, pool_.getThreadCount() * slicesPerWorker);
+
+        runParallel(tasks, [&](int task, WorkerCounters &counters)
+                    {
+            int firstBlock = static_cast<int>(static_cast<long long>(blocks) * task / tasks);
+            int lastBlock = static_cast<int>(static_cast<long long>(blocks) * (task + 1) / tasks);
+            int begin = firstBlock * baseBlockSize;
+            int end = std::min(lastBlock * baseBlockSize, n);
+
+            if (output != input)
+            {
+                std::copy(input + begin, input + end, output + begin);
+                counters.writes += end - begin;
+            }
+
+            // Full blocks of this stripe go through the batched networks, a
+            // short final block of the array through a single one
+            int stripeBlocks = (end - begin) / baseBlockSize;
+            networkSortBatch(output + begin, stripeBlocks, baseBlockSize);
+            counters.comparisons += static_cast<long long>(stripeBlocks) * SortingNetwork<baseBlockSize>::count;
+            counters.writes += static_cast<long long>(stripeBlocks) * baseBlockSize;
+            networkSort(output + begin + stripeBlocks * baseBlockSize, output + end, counters);
+            counters.elements += end - begin; });
+    }
+
+    // Merge every pair of runs of width currentSize_ from source_ into dest_,
+    // cutting the level's output into equal slices
+    void mergeLevel(int n)
+    {
+        int width = currentSize_;
+        int tasks = std::max(1, std::min(pool_.getThreadCount() * slicesPerWorker, n / baseBlockSize));
+
+        runParallel(tasks, [&](int task, WorkerCounters &counters)
+                    {
+            long long sliceBegin = static_cast<long long>(n) * task / tasks;
+            long long sliceEnd = static_cast<long long>(n) * (task + 1) / tasks;
+
+            // Walk every run pair that overlaps this slice of the output
+            long long pairSize = 2LL * width;
+            for (long long pairStart = (sliceBegin / pairSize) * pairSize; pairStart < sliceEnd; pairStart += pairSize)
+            {
+                int start = static_cast<int>(pairStart);
+                int mid = static_cast<int>(std::min<long long>(pairStart + width, n));
+                int end = static_cast<int>(std::min<long long>(pairStart + pairSize, n));
+
+                int outBegin = static_cast<int>(std::max<long long>(sliceBegin, start));
+                int outEnd = static_cast<int>(std::min<long long>(sliceEnd, end));
+                mergeSlice(start, mid, end, outBegin, outEnd, counters);
+            }
+            counters.elements += sliceEnd - sliceBegin; });
+    }
+
+    // Produce dest_[outBegin, outEnd) of the stable merge of source_[start, mid)
+    // and source_[mid, end)
+    void mergeSlice(int start, int mid, int end, int outBegin, int outEnd, WorkerCounters &counters)
+    {
+        const int *a = source_ + start;
+        const int *b = source_ + mid;
+        int lengthA = mid - start;
+        int lengthB = end - mid;
+
+        int i = coRank(outBegin - start, a, lengthA, b, lengthB, counters);
+        int j = (outBegin - start) - i;
+        int iEnd = coRank(outEnd - start, a, lengthA, b, lengthB, counters);
+        int jEnd = (outEnd - start) - iEnd;
+
+        mergeSorted(a + i, a + iEnd, b + j, b + jEnd, dest_ + outBegin);
+
+        MergeCount count = countMerge(a + i, a + iEnd, b + j, b + jEnd);
+        counters.comparisons += count.comparisons;
+        counters.swaps += count.fromSecond;
+        counters.writes += outEnd - outBegin;
+    }
+
+    // Merge path: how many of the first k outputs of the stable merge of a and b
+    // come from a (ties are taken from a first)
+    static int coRank(int k, const int *a, int lengthA, const int *b, int lengthB, WorkerCounters &counters)
+    {
+        int low = std::max(0, k - lengthB);
+        int high = std::min(k, lengthA);
+
+        while (low < high)
+        {
+            int i = low + (high - low) / 2;
+            int j = k - i;
+            counters.comparisons++;
+            if (a[i] <= b[j - 1])
+            {
+                low = i + 1;
+            }
+            else
+            {
+                high = i;
+            }
+        }
+        return low;
+    }
+
+    // Run body(task, counters) on the pool and fold the workers' counters into the metrics
+    template <typename Body>
+    void runParallel(int tasks, Body body)
+    {
+        for (auto &counters : workers_)
+        {
+            counters = WorkerCounters();
+        }
+
+        pool_.parallelFor(tasks, [&](int task, int worker)
+                          {
+            WorkerCounters &counters = workers_[worker];
+            auto start = Clock::now();
+            body(task, counters);
+            counters.busyTime += std::chrono::duration<double>(Clock::now() - start).count(); });
+
+        metrics_.addWorkerCounters(workers_);
+    }
+
+    ThreadPool &pool_;
+    std::vector<int> *array_; // Pointer to the original array
+    std::vector<int> buffer_; // Persistent scratch space, the other half of the ping-pong
+    std::vector<WorkerCounters> workers_;
+    int *source_ = nullptr;
+    int *dest_ = nullptr;
+    int currentSize_ = 0;
+};
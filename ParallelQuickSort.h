@@ -0,0 +1,210 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Quick Sort on the shared thread pool with work stealing. Every worker keeps
+// its pending partitions in its own deque: it partitions the newest one, pushes
+// both sides back and continues with the smaller, while idle workers steal the
+// oldest (largest) partitions of others, so unbalanced pivots are evened out
+// dynamically. Partitions below the grain size are sorted sequentially with the
+// Block Quick Sort kernel. Each update() runs one wave in which every worker
+// processes about a fixed budget of elements.
+class ParallelQuickSort final : public SteppedSortAlgorithm<ParallelQuickSort>
+{
+public:
+    ParallelQuickSort() : SteppedSortAlgorithm("Parallel Quick Sort"), pool_(ThreadPool::getShared()),
+                          deques_(pool_.getThreadCount()) {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        workers_.assign(pool_.getThreadCount(), WorkerCounters());
+        for (auto &deque : deques_)
+        {
+            deque.clear();
+        }
+
+        int n = static_cast<int>(array_->size());
+        int threads = pool_.getThreadCount();
+        grainSize_ = std::max(minGrainSize, std::min(maxGrainSize, n / (threads * 64)));
+        waveBudget_ = std::max<long long>(2LL * grainSize_, n / (2LL * threads));
+
+        pending_.store(0, std::memory_order_relaxed);
+        if (n > 1)
+        {
+            deques_[0].push({0, n, 2 * floorLog2(n), true});
+            pending_.store(1, std::memory_order_relaxed);
+        }
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning || pending_.load(std::memory_order_acquire) == 0)
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+
+        runWave();
+
+        if (pending_.load(std::memory_order_acquire) == 0)
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    struct Range
+    {
+        int first;
+        int last;
+        int depthLimit;
+        bool leftmost; // No smaller key precedes the range
+    };
+
+    static constexpr int minGrainSize = 32;
+    static constexpr int maxGrainSize = 16384;
+
+    using Clock = std::chrono::steady_clock;
+
+    // One wave: every worker takes tasks from its own deque or steals until its
+    // budget is spent or no partition is left anywhere
+    void runWave()
+    {
+        for (auto &counters : workers_)
+        {
+            counters = WorkerCounters();
+        }
+
+        pool_.parallelFor(pool_.getThreadCount(), [&](int, int worker)
+                          {
+            WorkerCounters &counters = workers_[worker];
+            auto start = Clock::now();
+            workLoop(worker, counters);
+            counters.busyTime += std::chrono::duration<double>(Clock::now() - start).count(); });
+
+        metrics_.addWorkerCounters(workers_);
+    }
+
+    void workLoop(int worker, WorkerCounters &counters)
+    {
+        long long processed = 0;
+        Range range;
+
+        while (processed < waveBudget_)
+        {
+            if (!deques_[worker].pop(range) && !steal(worker, range))
+            {
+                // Partitions still in flight elsewhere may produce more work
+                if (pending_.load(std::memory_order_acquire) == 0)
+                {
+                    break;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+
+            processed += processRange(range, worker, counters);
+        }
+    }
+
+    // Try every other worker's deque once, starting with the next one
+    bool steal(int worker, Range &range)
+    {
+        int threads = static_cast<int>(deques_.size());
+        for (int offset = 1; offset < threads; ++offset)
+        {
+            if (deques_[(worker + offset) % threads].steal(range))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Partition one range and push its sides, or sort it outright if it is
+    // below the grain size; returns the number of elements touched
+    int processRange(const Range &range, int worker, WorkerCounters &counters)
+    {
+        int *data = array_->data();
+        int *first = data + range.first;
+        int *last = data + range.last;
+        int size = range.last - range.first;
+
+        if (size <= grainSize_ || range.depthLimit == 0)
+        {
+            quickSortRange(first, last, range.leftmost, range.depthLimit, counters);
+        }
+        else
+        {
+            selectPivotToFront(first, last, counters);
+
+            bool equalToPredecessor = false;
+            if (!range.leftmost)
+            {
+                counters.comparisons++;
+                equalToPredecessor = !(data[range.first - 1] < *first);
+            }
+
+            if (equalToPredecessor)
+            {
+                int equalEnd = static_cast<int>(partitionEqualLeft(first, last, counters) - data);
+                pushRange({equalEnd + 1, range.last, range.depthLimit, false}, worker);
+            }
+            else
+            {
+                int pivot = static_cast<int>(partitionBlock(first, last, counters) - data);
+
+                // Push the larger side first: the owner pops the smaller one
+                // next, thieves take the larger one from the front
+                Range left = {range.first, pivot, range.depthLimit - 1, range.leftmost};
+                Range right = {pivot + 1, range.last, range.depthLimit - 1, false};
+                if (left.last - left.first < right.last - right.first)
+                {
+                    std::swap(left, right);
+                }
+                pushRange(left, worker);
+                pushRange(right, worker);
+            }
+        }
+
+        counters.elements += size;
+        pending_.fetch_sub(1, std::memory_order_acq_rel);
+        return size;
+    }
+
+    void pushRange(const Range &range, int worker)
+    {
+        if (range.last - range.first > 1)
+        {
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            deques_[worker].push(range);
+        }
+    }
+
+    ThreadPool &pool_;
+    std::vector<int> *array_; // Pointer to the original array
+    std::vector<WorkStealingDeque<Range>> deques_; // One per worker
+    std::vector<WorkerCounters> workers_;
+    std::atomic<long long> pending_{0}; // Ranges queued or being partitioned
+    int grainSize_ = minGrainSize;
+    long long waveBudget_ = 0; // Elements each worker processes per update()
+};
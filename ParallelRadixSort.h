@@ -0,0 +1,513 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <stack>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+// In-place most-significant-digit radix sort (American flag sort) on the
+// shared thread pool. Keys are split by 8-bit digits, starting at the highest
+// bit in which the smallest and largest key differ. Elements are moved into
+// their buckets with cycle-leader swaps, so besides a few histograms per
+// thread no memory is needed. Large ranges are permuted by all threads at once
+// (PARADIS-style: every thread cycles elements within its own share of each
+// bucket, then a repair pass gathers what ended up in the wrong bucket), and
+// buckets are sorted in parallel, recursing digit by digit down to a
+// comparison-sort base case.
+//
+// update() runs one phase at a time (key range, histogram, permutation), then
+// sorts a batch of small buckets per update().
+class ParallelRadixSort final : public SteppedSortAlgorithm<ParallelRadixSort>
+{
+public:
+    ParallelRadixSort() : SteppedSortAlgorithm("Parallel MSD Radix Sort"), pool_(ThreadPool::getShared()) {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        tasks_ = std::stack<Range>();
+        smallBuckets_.clear();
+        nextSmallBucket_ = 0;
+        step_ = array_->size() > 1 ? Step::MeasureRange : Step::Next;
+
+        int threads = pool_.getThreadCount();
+        workers_.assign(threads, WorkerCounters());
+        threadState_.resize(threads);
+
+        metrics_.resetMetrics();
+        metrics_.noteAuxMemory(static_cast<long long>(threadState_.size() * sizeof(ThreadState)));
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        switch (step_)
+        {
+        case Step::MeasureRange:
+            measureRange();
+            step_ = Step::Next;
+            break;
+
+        case Step::Next:
+            if (!tasks_.empty())
+            {
+                current_ = tasks_.top();
+                tasks_.pop();
+                countParallel();
+                step_ = Step::Permute;
+            }
+            else if (nextSmallBucket_ < smallBuckets_.size())
+            {
+                sortSmallBuckets();
+            }
+            break;
+
+        case Step::Permute:
+            permuteParallel();
+            queueBuckets();
+            step_ = Step::Next;
+            break;
+        }
+
+        if (step_ == Step::Next && tasks_.empty() && nextSmallBucket_ == smallBuckets_.size())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    static constexpr int radixBits = 8;
+    static constexpr int radix = 1 << radixBits;
+    static constexpr int baseCaseSize = 256;         // Comparison sort below this
+    static constexpr int parallelCutoff = 1 << 16;   // Smaller ranges are sorted by one thread
+    static constexpr int minStripeSize = 1 << 14;
+    static constexpr int smallBucketsPerWorker = 4;  // Small buckets sorted per update() and thread
+
+    enum class Step
+    {
+        MeasureRange,
+        Next,
+        Permute
+    };
+
+    // A range whose keys agree above bit shift + width; its buckets are given
+    // by the width bits starting at shift
+    struct Range
+    {
+        int first;
+        int last;
+        int shift;
+        int width;
+    };
+
+    // Per-thread histogram and bucket pointers, padded against false sharing
+    struct alignas(64) ThreadState
+    {
+        int counts[radix];
+        int head[radix];
+        int end[radix];
+        uint32_t minKey;
+        uint32_t maxKey;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    static uint32_t toUnsigned(int key)
+    {
+        return static_cast<uint32_t>(key) ^ 0x80000000u;
+    }
+
+    static int digitOf(int key, int shift, int width)
+    {
+        return static_cast<int>((toUnsigned(key) >> shift) & ((1u << width) - 1));
+    }
+
+    // The digits of the next level below a range's digit
+    static Range childRange(int first, int last, int shift)
+    {
+        int width = std::min(radixBits, shift);
+        return {first, last, shift - width, width};
+    }
+
+    // Find the highest bit in which keys differ and queue the whole array.
+    // Timed as its own "range" phase, apart from the histograms.
+    void measureRange()
+    {
+        int n = static_cast<int>(array_->size());
+        int stripes = std::max(1, std::min(pool_.getThreadCount(), n / minStripeSize));
+        const int *data = array_->data();
+
+        runParallel(stripes, "range", [&](int stripe, int, WorkerCounters &counters)
+                    {
+            ThreadState &state = threadState_[stripe];
+            int begin = static_cast<int>(static_cast<long long>(n) * stripe / stripes);
+            int end = static_cast<int>(static_cast<long long>(n) * (stripe + 1) / stripes);
+            uint32_t low = UINT32_MAX;
+            uint32_t high = 0;
+            for (int i = begin; i < end; ++i)
+            {
+                uint32_t key = toUnsigned(data[i]);
+                low = std::min(low, key);
+                high = std::max(high, key);
+            }
+            state.minKey = low;
+            state.maxKey = high;
+            counters.comparisons += 2LL * (end - begin); });
+
+        uint32_t low = UINT32_MAX;
+        uint32_t high = 0;
+        for (int t = 0; t < stripes; ++t)
+        {
+            low = std::min(low, threadState_[t].minKey);
+            high = std::max(high, threadState_[t].maxKey);
+        }
+
+        // Bits above the highest differing one are the same in every key
+        int bits = 0;
+        for (uint32_t differing = low ^ high; differing != 0; differing >>= 1)
+        {
+            ++bits;
+        }
+        if (bits == 0)
+        {
+            return;
+        }
+
+        int width = std::min(radixBits, bits);
+        queueRange({0, n, bits - width, width}, n);
+    }
+
+    void queueRange(const Range &range, int n)
+    {
+        int size = range.last - range.first;
+        if (size <= 1)
+        {
+            return;
+        }
+
+        if (size > std::max(parallelCutoff, n / pool_.getThreadCount()))
+        {
+            tasks_.push(range);
+        }
+        else
+        {
+            smallBuckets_.push_back(range);
+        }
+    }
+
+    // Histogram of the current range, one stripe per thread
+    void countParallel()
+    {
+        int size = current_.last - current_.first;
+        stripes_ = std::max(1, std::min(pool_.getThreadCount(), size / minStripeSize));
+        const int *data = array_->data() + current_.first;
+
+        runParallel(stripes_, "histogram", [&](int stripe, int, WorkerCounters &counters)
+                    {
+            ThreadState &state = threadState_[stripe];
+            std::fill(state.counts, state.counts + radix, 0);
+            int begin = static_cast<int>(static_cast<long long>(size) * stripe / stripes_);
+            int end = static_cast<int>(static_cast<long long>(size) * (stripe + 1) / stripes_);
+            for (int i = begin; i < end; ++i)
+            {
+                ++state.counts[digitOf(data[i], current_.shift, current_.width)];
+            }
+            counters.elements += end - begin; });
+
+        bucketStart_[0] = 0;
+        for (int b = 0; b < radix; ++b)
+        {
+            int count = 0;
+            for (int t = 0; t < stripes_; ++t)
+            {
+                count += threadState_[t].counts[b];
+            }
+            bucketStart_[b + 1] = bucketStart_[b] + count;
+        }
+    }
+
+    // Move every element of the current range into its bucket. Each round
+    // splits the unfinished part of every bucket among the threads, lets each
+    // thread cycle elements within its own parts, and then gathers the
+    // elements that landed in the right bucket at the bucket's front. Once a
+    // round makes too little progress, one thread finishes the permutation.
+    void permuteParallel()
+    {
+        int *data = array_->data() + current_.first;
+        int buckets = 1 << current_.width;
+        int shift = current_.shift;
+        int width = current_.width;
+
+        for (int b = 0; b < buckets; ++b)
+        {
+            unfinished_[b] = bucketStart_[b];
+        }
+
+        long long remaining = current_.last - current_.first;
+        int threads = stripes_;
+        while (remaining > 0)
+        {
+            if (threads == 1)
+            {
+                runParallel(1, "permutation", [&](int, int, WorkerCounters &counters)
+                            {
+                    ThreadState &state = threadState_[0];
+                    for (int b = 0; b < buckets; ++b)
+                    {
+                        state.head[b] = unfinished_[b];
+                        state.end[b] = bucketStart_[b + 1];
+                    }
+                    cycleExact(data, state, buckets, shift, width, counters); });
+                break;
+            }
+
+            runParallel(threads, "permutation", [&](int thread, int, WorkerCounters &counters)
+                        {
+                ThreadState &state = threadState_[thread];
+                for (int b = 0; b < buckets; ++b)
+                {
+                    long long length = bucketStart_[b + 1] - unfinished_[b];
+                    state.head[b] = unfinished_[b] + static_cast<int>(length * thread / threads);
+                    state.end[b] = unfinished_[b] + static_cast<int>(length * (thread + 1) / threads);
+                }
+                cyclePermute(data, state, buckets, shift, width, counters); });
+
+            int tasks = std::min(buckets, threads * 4);
+            runParallel(tasks, "repair", [&](int task, int, WorkerCounters &counters)
+                        {
+                for (int b = buckets * task / tasks; b < buckets * (task + 1) / tasks; ++b)
+                {
+                    counters.elements += bucketStart_[b + 1] - unfinished_[b];
+                    unfinished_[b] = gatherBucket(data, unfinished_[b], bucketStart_[b + 1], b, shift, width, counters);
+                } });
+
+            long long left = 0;
+            for (int b = 0; b < buckets; ++b)
+            {
+                left += bucketStart_[b + 1] - unfinished_[b];
+            }
+
+            // A round that places less than half of the rest is not worth the repair pass
+            if (left * 2 > remaining)
+            {
+                threads = 1;
+            }
+            remaining = left;
+        }
+    }
+
+    // Cycle-leader permutation within [head[b], end[b]) of every bucket. An
+    // element whose bucket has no room left is parked in the current slot.
+    static void cyclePermute(int *data, ThreadState &state, int buckets, int shift, int width, WorkerCounters &counters)
+    {
+        int *head = state.head;
+        const int *end = state.end;
+
+        for (int b = 0; b < buckets; ++b)
+        {
+            while (head[b] < end[b])
+            {
+                int value = data[head[b]];
+                int digit = digitOf(value, shift, width);
+                while (digit != b && head[digit] < end[digit])
+                {
+                    std::swap(value, data[head[digit]++]);
+                    digit = digitOf(value, shift, width);
+                    counters.swaps++;
+                    counters.writes++;
+                }
+                data[head[b]++] = value;
+                counters.writes++;
+            }
+        }
+    }
+
+    // Cycle-leader permutation when every bucket's part holds exactly as many
+    // slots as keys belong to it, so no chain can run out of room
+    static void cycleExact(int *data, ThreadState &state, int buckets, int shift, int width, WorkerCounters &counters)
+    {
+        int *head = state.head;
+        const int *end = state.end;
+        long long swaps = 0;
+        long long cycles = 0;
+
+        for (int b = 0; b < buckets; ++b)
+        {
+            while (head[b] < end[b])
+            {
+                int value = data[head[b]];
+                int digit = digitOf(value, shift, width);
+                while (digit != b)
+                {
+                    std::swap(value, data[head[digit]++]);
+                    digit = digitOf(value, shift, width);
+                    ++swaps;
+                }
+                data[head[b]++] = value;
+                ++cycles;
+            }
+        }
+        counters.swaps += swaps;
+        counters.writes += swaps + cycles;
+    }
+
+    // Move the elements of [begin, end) that belong to bucket to the front;
+    // returns the first position that is not yet final
+    static int gatherBucket(int *data, int begin, int end, int bucket, int shift, int width, WorkerCounters &counters)
+    {
+        while (true)
+        {
+            while (begin < end && digitOf(data[begin], shift, width) == bucket)
+            {
+                ++begin;
+            }
+            while (begin < end && digitOf(data[end - 1], shift, width) != bucket)
+            {
+                --end;
+            }
+            if (begin >= end)
+            {
+                return begin;
+            }
+            std::swap(data[begin++], data[--end]);
+            counters.swaps++;
+            counters.writes += 2;
+        }
+    }
+
+    void queueBuckets()
+    {
+        int n = static_cast<int>(array_->size());
+        for (int b = 0; b < (1 << current_.width); ++b)
+        {
+            if (current_.shift > 0)
+            {
+                queueRange(childRange(current_.first + bucketStart_[b], current_.first + bucketStart_[b + 1], current_.shift), n);
+            }
+        }
+    }
+
+    // Sort the next batch of small buckets, one bucket per task
+    void sortSmallBuckets()
+    {
+        size_t batch = std::min(smallBuckets_.size() - nextSmallBucket_,
+                                static_cast<size_t>(pool_.getThreadCount() * smallBucketsPerWorker));
+        size_t first = nextSmallBucket_;
+        nextSmallBucket_ += batch;
+
+        runParallel(static_cast<int>(batch), "buckets", [&](int task, int, WorkerCounters &counters)
+                    {
+            const Range &range = smallBuckets_[first + task];
+            int *data = array_->data();
+            sortSequential(data + range.first, data + range.last, range.shift, range.width, counters);
+            counters.elements += range.last - range.first; });
+    }
+
+    // American flag sort of [first, last) by a single thread
+    static void sortSequential(int *first, int *last, int shift, int width, WorkerCounters &counters)
+    {
+        int size = static_cast<int>(last - first);
+        if (size <= baseCaseSize)
+        {
+            // The neighbouring buckets may be in use by other threads, so the
+            // key before the range cannot serve as a lower bound
+            quickSortRange(first, last, true, 2 * floorLog2(std::max(size, 1)), counters);
+            return;
+        }
+
+        ThreadState state;
+        int buckets = 1 << width;
+        std::fill(state.counts, state.counts + buckets, 0);
+        for (int *key = first; key < last; ++key)
+        {
+            ++state.counts[digitOf(*key, shift, width)];
+        }
+
+        int start = 0;
+        bool trivial = false;
+        for (int b = 0; b < buckets; ++b)
+        {
+            trivial |= state.counts[b] == size;
+            state.head[b] = start;
+            start += state.counts[b];
+            state.end[b] = start;
+        }
+
+        if (!trivial)
+        {
+            cycleExact(first, state, buckets, shift, width, counters);
+        }
+        if (shift == 0)
+        {
+            return;
+        }
+
+        // head[b] now equals end[b], the end of bucket b
+        int begin = 0;
+        for (int b = 0; b < buckets; ++b)
+        {
+            Range child = childRange(begin, state.end[b], shift);
+            if (child.last - child.first > 1)
+            {
+                sortSequential(first + child.first, first + child.last, child.shift, child.width, counters);
+            }
+            begin = state.end[b];
+        }
+    }
+
+    // Run body(task, worker, counters) on the pool, fold the workers'
+    // counters into the metrics and book the time under the given phase
+    template <typename Body>
+    void runParallel(int tasks, const char *phase, Body body)
+    {
+        for (auto &counters : workers_)
+        {
+            counters = WorkerCounters();
+        }
+
+        pool_.parallelFor(tasks, [&](int task, int worker)
+                          {
+            WorkerCounters &counters = workers_[worker];
+            auto start = Clock::now();
+            body(task, worker, counters);
+            counters.busyTime += std::chrono::duration<double>(Clock::now() - start).count(); });
+
+        metrics_.addWorkerCounters(workers_);
+        double seconds = 0.0;
+        for (const auto &counters : workers_)
+        {
+            seconds += counters.busyTime;
+        }
+        metrics_.addPhaseTime(phase, seconds);
+    }
+
+    ThreadPool &pool_;
+    std::vector<int> *array_; // Pointer to the original array
+    std::vector<WorkerCounters> workers_;
+    std::vector<ThreadState> threadState_;
+    std::stack<Range> tasks_;         // Ranges permuted by all threads
+    std::vector<Range> smallBuckets_; // Ranges sorted by a single thread each
+    size_t nextSmallBucket_ = 0;
+    Range current_ = {0, 0, 0, 0};
+    int stripes_ = 1;
+    int bucketStart_[radix + 1];
+    int unfinished_[radix]; // First position of each bucket not known to be final
+    Step step_ = Step::Next;
+};
@@ -0,0 +1,895 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include "ThreadPool.h"
+#include <vector>
+#include <stack>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <memory>
+#include <mutex>
+
+// In-place parallel samplesort after Axtmann, Witt, Ferizovic and Sanders
+// (IPS4o). A sorted random sample provides up to 255 splitters, stored as an
+// implicit search tree so every key is classified with a fixed number of
+// branchless comparisons. Each thread classifies one stripe of the range into
+// small per-bucket buffers and writes full blocks back into its own stripe;
+// the blocks are then permuted into their buckets in place, and a cleanup pass
+// fills the bucket edges from the partly filled buffers. Buckets at least as
+// large as a thread's share are split again by all threads, smaller ones are
+// sorted by a single thread each. When the sample has duplicates, keys equal
+// to a splitter get buckets of their own, which never need sorting.
+//
+// update() runs one phase at a time (sampling, classification, block
+// permutation, cleanup), then sorts a batch of small buckets per update().
+class ParallelSampleSort final : public SteppedSortAlgorithm<ParallelSampleSort>
+{
+public:
+    ParallelSampleSort() : SteppedSortAlgorithm("Parallel Sample Sort"), pool_(ThreadPool::getShared()) {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        tasks_ = std::stack<Range>();
+        smallBuckets_.clear();
+        nextSmallBucket_ = 0;
+        step_ = Step::Sample;
+
+        int threads = pool_.getThreadCount();
+        workers_.assign(threads, WorkerCounters());
+        phaseSeconds_.assign(threads, PhaseSeconds());
+
+        int n = static_cast<int>(array_->size());
+        if (n > sequentialCutoff)
+        {
+            allocateLevels(threads);
+            tasks_.push({0, n, false});
+        }
+        else if (n > 1)
+        {
+            smallBuckets_.push_back({0, n, false});
+        }
+
+        metrics_.resetMetrics();
+        if (n > sequentialCutoff)
+        {
+            long long bytes = levelBytes(*topLevel_);
+            for (const auto &level : workerLevels_)
+            {
+                bytes += levelBytes(*level);
+            }
+            metrics_.noteAuxMemory(bytes);
+        }
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        switch (step_)
+        {
+        case Step::Sample:
+            if (!tasks_.empty())
+            {
+                current_ = tasks_.top();
+                tasks_.pop();
+                startParallelLevel();
+                step_ = Step::Classify;
+            }
+            else if (nextSmallBucket_ < smallBuckets_.size())
+            {
+                sortSmallBuckets();
+            }
+            break;
+
+        case Step::Classify:
+            classifyParallel();
+            step_ = Step::Permute;
+            break;
+
+        case Step::Permute:
+            permuteParallel();
+            step_ = Step::Cleanup;
+            break;
+
+        case Step::Cleanup:
+            cleanupParallel();
+            queueBuckets();
+            step_ = Step::Sample;
+            break;
+        }
+
+        if (step_ == Step::Sample && tasks_.empty() && nextSmallBucket_ == smallBuckets_.size())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    static constexpr int blockSize = 256;                    // Elements per block (1 KiB)
+    static constexpr int maxLogBuckets = 8;                  // Up to 256 buckets...
+    static constexpr int maxBuckets = 2 << maxLogBuckets;    // ...or 512 with equality buckets
+    static constexpr int sequentialCutoff = 1 << 14;         // Smaller ranges use quickSortRange()
+    static constexpr int minStripeSize = 1 << 14;
+    static constexpr int smallBucketsPerWorker = 4;          // Small buckets sorted per update() and thread
+
+    enum class Step
+    {
+        Sample,
+        Classify,
+        Permute,
+        Cleanup
+    };
+
+    enum Phase
+    {
+        Sampling,
+        Classification,
+        Permutation,
+        Cleanup,
+        BaseCase,
+        PhaseCount
+    };
+
+    struct Range
+    {
+        int first;
+        int last;
+        bool direct; // Sampling made no progress: sort with quickSortRange()
+    };
+
+    struct PhaseSeconds
+    {
+        double seconds[PhaseCount] = {};
+    };
+
+    // One thread's slice of a level: classification buffers and results
+    struct Stripe
+    {
+        std::vector<int> buffers; // blockSize slots per bucket
+        int fill[maxBuckets];     // Keys waiting in each bucket's buffer
+        int counts[maxBuckets];   // Keys of each bucket seen in this stripe
+        int begin;
+        int end;
+        int writeEnd; // Full blocks were written to [begin, writeEnd)
+        int swapBuffers[2][blockSize];
+    };
+
+    // State of one partitioning step. Offsets are relative to data.
+    struct Level
+    {
+        int *data = nullptr;
+        int size = 0;
+        unsigned long long rng = 0x9E3779B97F4A7C15ULL;
+
+        int logBuckets = 1;
+        int buckets = 2;             // Buckets of the splitter tree
+        int numBuckets = 2;          // Including equality buckets
+        bool equalityBuckets = false;
+        int tree[maxBuckets / 2];    // Splitters in Eytzinger order, tree[1..buckets)
+        int splitters[maxBuckets / 2]; // Sorted splitters, splitters[buckets - 1] = INT_MAX
+
+        std::vector<Stripe> stripes;
+        int stripeCount = 1; // Stripes in use
+        int bucketStart[maxBuckets + 1];
+        int blockStart[maxBuckets + 1]; // bucketStart rounded up to whole blocks
+        int writePos[maxBuckets];       // Next block to fill in each bucket
+        int readPos[maxBuckets];        // Last unprocessed block in each bucket
+        std::mutex locks[maxBuckets];
+
+        std::vector<int> holes; // Empty blocks left of the full-block boundary
+        std::vector<int> fulls; // Full blocks right of it
+        std::vector<int> spill; // Block tails that ran into the next bucket
+        int overflow[blockSize]; // Stands in for the block crossing the array end
+        int overflowSlot = -1;
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    void allocateLevels(int threads)
+    {
+        if (!topLevel_)
+        {
+            topLevel_ = std::make_unique<Level>();
+        }
+        allocateStripes(*topLevel_, threads);
+
+        while (static_cast<int>(workerLevels_.size()) < threads)
+        {
+            workerLevels_.push_back(std::make_unique<Level>());
+        }
+        for (auto &level : workerLevels_)
+        {
+            allocateStripes(*level, 1);
+        }
+    }
+
+    // Memory held by a level: its bucket tables and the stripes' block buffers
+    static long long levelBytes(const Level &level)
+    {
+        long long bytes = static_cast<long long>(sizeof(Level) + level.spill.size() * sizeof(int));
+        for (const auto &stripe : level.stripes)
+        {
+            bytes += static_cast<long long>(sizeof(Stripe) + stripe.buffers.size() * sizeof(int));
+        }
+        return bytes;
+    }
+
+    static void allocateStripes(Level &level, int count)
+    {
+        if (static_cast<int>(level.stripes.size()) < count)
+        {
+            level.stripes.resize(count);
+        }
+        for (auto &stripe : level.stripes)
+        {
+            stripe.buffers.resize(maxBuckets * blockSize);
+        }
+        level.spill.resize(maxBuckets * blockSize);
+    }
+
+    void startParallelLevel()
+    {
+        Level &level = *topLevel_;
+        level.data = array_->data() + current_.first;
+        level.size = current_.last - current_.first;
+
+        auto start = Clock::now();
+        selectSplitters(level, metrics_);
+        int stripes = std::max(1, std::min(pool_.getThreadCount(), level.size / minStripeSize));
+        setupStripes(level, stripes);
+        metrics_.addPhaseTime(phaseName(Sampling), secondsSince(start));
+    }
+
+    void classifyParallel()
+    {
+        Level &level = *topLevel_;
+        runParallel(level.stripeCount, [&](int stripe, int worker, WorkerCounters &counters)
+                    {
+            auto start = Clock::now();
+            classifyStripe(level, level.stripes[stripe], counters);
+            counters.elements += level.stripes[stripe].end - level.stripes[stripe].begin;
+            phaseSeconds_[worker].seconds[Classification] += secondsSince(start); });
+    }
+
+    void permuteParallel()
+    {
+        Level &level = *topLevel_;
+        int threads = level.stripeCount;
+
+        int moves = prepareBlocks(level);
+        runParallel(std::min(moves, threads), [&](int task, int worker, WorkerCounters &counters)
+                    {
+            auto start = Clock::now();
+            int tasks = std::min(moves, threads);
+            for (int i = moves * task / tasks; i < moves * (task + 1) / tasks; ++i)
+            {
+                moveBlock(level, level.fulls[i], level.holes[i], counters);
+            }
+            phaseSeconds_[worker].seconds[Permutation] += secondsSince(start); });
+
+        runParallel(threads, [&](int thread, int worker, WorkerCounters &counters)
+                    {
+            auto start = Clock::now();
+            permuteBlocks(level, thread, threads, counters);
+            phaseSeconds_[worker].seconds[Permutation] += secondsSince(start); });
+    }
+
+    void cleanupParallel()
+    {
+        Level &level = *topLevel_;
+        int tasks = std::min(level.numBuckets, level.stripeCount * 4);
+
+        restoreOverflow(level, metrics_);
+        runParallel(tasks, [&](int task, int worker, WorkerCounters &counters)
+                    {
+            auto start = Clock::now();
+            for (int b = level.numBuckets * task / tasks; b < level.numBuckets * (task + 1) / tasks; ++b)
+            {
+                saveSpill(level, b, counters);
+            }
+            phaseSeconds_[worker].seconds[Cleanup] += secondsSince(start); });
+
+        runParallel(tasks, [&](int task, int worker, WorkerCounters &counters)
+                    {
+            auto start = Clock::now();
+            for (int b = level.numBuckets * task / tasks; b < level.numBuckets * (task + 1) / tasks; ++b)
+            {
+                fillBucket(level, b, counters);
+            }
+            phaseSeconds_[worker].seconds[Cleanup] += secondsSince(start); });
+    }
+
+    // Buckets at least as large as one thread's share become parallel levels
+    // of their own, the rest wait for the sequential phase
+    void queueBuckets()
+    {
+        const Level &level = *topLevel_;
+        int n = static_cast<int>(array_->size());
+        int parallelThreshold = std::max(sequentialCutoff, n / pool_.getThreadCount());
+
+        for (int b = 0; b < level.numBuckets; ++b)
+        {
+            Range bucket = {current_.first + level.bucketStart[b], current_.first + level.bucketStart[b + 1], false};
+            int size = bucket.last - bucket.first;
+            if (size <= 1 || isEqualityBucket(level, b))
+            {
+                continue;
+            }
+
+            if (size == level.size)
+            {
+                bucket.direct = true;
+                smallBuckets_.push_back(bucket);
+            }
+            else if (size > parallelThreshold)
+            {
+                tasks_.push(bucket);
+            }
+            else
+            {
+                smallBuckets_.push_back(bucket);
+            }
+        }
+    }
+
+    // Sort the next batch of small buckets, one bucket per task
+    void sortSmallBuckets()
+    {
+        size_t batch = std::min(smallBuckets_.size() - nextSmallBucket_,
+                                static_cast<size_t>(pool_.getThreadCount() * smallBucketsPerWorker));
+        size_t first = nextSmallBucket_;
+        nextSmallBucket_ += batch;
+
+        runParallel(static_cast<int>(batch), [&](int task, int worker, WorkerCounters &counters)
+                    {
+            // Another thread may be sorting the previous bucket, so the key before
+            // this one cannot serve as a lower bound (leftmost = true)
+            const Range &bucket = smallBuckets_[first + task];
+            int *data = array_->data();
+            if (bucket.direct)
+            {
+                auto start = Clock::now();
+                int size = bucket.last - bucket.first;
+                quickSortRange(data + bucket.first, data + bucket.last, true, 2 * floorLog2(size), counters);
+                phaseSeconds_[worker].seconds[BaseCase] += secondsSince(start);
+            }
+            else
+            {
+                sortSequential(data + bucket.first, data + bucket.last, true, worker, counters);
+            }
+            counters.elements += bucket.last - bucket.first; });
+    }
+
+    // Samplesort of [first, last) by a single thread, recursing into the buckets.
+    // Unless leftmost, *(first - 1) must bound the range from below.
+    void sortSequential(int *first, int *last, bool leftmost, int worker, WorkerCounters &counters)
+    {
+        int size = static_cast<int>(last - first);
+        double *seconds = phaseSeconds_[worker].seconds;
+
+        if (size <= sequentialCutoff)
+        {
+            auto start = Clock::now();
+            quickSortRange(first, last, leftmost, 2 * floorLog2(size), counters);
+            seconds[BaseCase] += secondsSince(start);
+            return;
+        }
+
+        Level &level = *workerLevels_[worker];
+        level.data = first;
+        level.size = size;
+
+        auto start = Clock::now();
+        selectSplitters(level, counters);
+        setupStripes(level, 1);
+        seconds[Sampling] += secondsSince(start);
+
+        start = Clock::now();
+        classifyStripe(level, level.stripes[0], counters);
+        seconds[Classification] += secondsSince(start);
+
+        // A single stripe already has its full blocks at the front
+        start = Clock::now();
+        prepareBlocks(level);
+        permuteBlocks(level, 0, 1, counters);
+        seconds[Permutation] += secondsSince(start);
+
+        start = Clock::now();
+        restoreOverflow(level, counters);
+        for (int b = 0; b < level.numBuckets; ++b)
+        {
+            saveSpill(level, b, counters);
+        }
+        for (int b = 0; b < level.numBuckets; ++b)
+        {
+            fillBucket(level, b, counters);
+        }
+        seconds[Cleanup] += secondsSince(start);
+
+        // The level is reused by the recursion, so keep the bucket bounds
+        int bounds[maxBuckets + 1];
+        int numBuckets = level.numBuckets;
+        bool equalityBuckets = level.equalityBuckets;
+        std::copy(level.bucketStart, level.bucketStart + numBuckets + 1, bounds);
+
+        for (int b = 0; b < numBuckets; ++b)
+        {
+            int bucketSize = bounds[b + 1] - bounds[b];
+            if (bucketSize <= 1 || (equalityBuckets && (b & 1)))
+            {
+                continue;
+            }
+
+            int *bucketFirst = first + bounds[b];
+            bool bucketLeftmost = leftmost && b == 0;
+            if (bucketSize == size)
+            {
+                quickSortRange(bucketFirst, bucketFirst + bucketSize, bucketLeftmost, 2 * floorLog2(bucketSize), counters);
+            }
+            else
+            {
+                sortSequential(bucketFirst, bucketFirst + bucketSize, bucketLeftmost, worker, counters);
+            }
+        }
+    }
+
+    // Draw a random sample to the front of the range, sort it and build the
+    // splitter tree from equally spaced sample keys
+    template <typename Counters>
+    void selectSplitters(Level &level, Counters &counters)
+    {
+        int n = level.size;
+        int *data = level.data;
+
+        int logBuckets = std::max(1, std::min(maxLogBuckets, floorLog2(n / 512)));
+        int buckets = 1 << logBuckets;
+        int oversampling = std::max(1, floorLog2(n) / 5);
+        int sampleSize = std::min(n, buckets * oversampling);
+
+        for (int i = 0; i < sampleSize; ++i)
+        {
+            int j = i + static_cast<int>(nextRandom(level) % static_cast<unsigned long long>(n - i));
+            std::swap(data[i], data[j]);
+        }
+        counters.swaps += sampleSize;
+        counters.writes += 2LL * sampleSize;
+        quickSortRange(data, data + sampleSize, true, 2 * floorLog2(sampleSize), counters);
+
+        // Equally spaced sample keys, with duplicates removed
+        int count = 0;
+        bool duplicates = false;
+        for (int i = 1; i < buckets; ++i)
+        {
+            int key = data[static_cast<long long>(sampleSize) * i / buckets];
+            if (count > 0 && !(level.splitters[count - 1] < key))
+            {
+                duplicates = true;
+                continue;
+            }
+            level.splitters[count++] = key;
+        }
+        counters.comparisons += buckets - 1;
+
+        // Shrink the tree to the distinct splitters, padding with the largest
+        logBuckets = 1;
+        while ((1 << logBuckets) < count + 1)
+        {
+            ++logBuckets;
+        }
+        buckets = 1 << logBuckets;
+        std::fill(level.splitters + count, level.splitters + buckets - 1, level.splitters[count - 1]);
+        level.splitters[buckets - 1] = INT_MAX;
+
+        level.logBuckets = logBuckets;
+        level.buckets = buckets;
+        level.equalityBuckets = duplicates;
+        level.numBuckets = duplicates ? 2 * buckets : buckets;
+        buildTree(level);
+    }
+
+    // Lay out the sorted splitters as a complete search tree in Eytzinger
+    // order: node i has children 2i and 2i + 1
+    static void buildTree(Level &level)
+    {
+        for (int node = 1; node < level.buckets; ++node)
+        {
+            int depth = floorLog2(node);
+            int position = node - (1 << depth);
+            int span = 1 << (level.logBuckets - depth - 1);
+            level.tree[node] = level.splitters[(2 * position + 1) * span - 1];
+        }
+    }
+
+    static unsigned long long nextRandom(Level &level)
+    {
+        // splitmix64
+        unsigned long long z = (level.rng += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    // Bucket of key: the number of splitters smaller than it, doubled when
+    // keys equal to their bucket's splitter get an equality bucket
+    static int classify(const Level &level, int key)
+    {
+        int node = 1;
+        for (int i = 0; i < level.logBuckets; ++i)
+        {
+            node = 2 * node + (level.tree[node] < key);
+        }
+        return bucketOf(level, node, key);
+    }
+
+    static int bucketOf(const Level &level, int node, int key)
+    {
+        int bucket = node - level.buckets;
+        if (level.equalityBuckets)
+        {
+            bucket = 2 * bucket + !(key < level.splitters[bucket]);
+        }
+        return bucket;
+    }
+
+    static bool isEqualityBucket(const Level &level, int bucket)
+    {
+        return level.equalityBuckets && (bucket & 1);
+    }
+
+    // Split the range into stripes of whole blocks
+    static void setupStripes(Level &level, int count)
+    {
+        int blocks = (level.size + blockSize - 1) / blockSize;
+        for (int t = 0; t < count; ++t)
+        {
+            Stripe &stripe = level.stripes[t];
+            stripe.begin = static_cast<int>(static_cast<long long>(blocks) * t / count) * blockSize;
+            stripe.end = std::min(level.size, static_cast<int>(static_cast<long long>(blocks) * (t + 1) / count) * blockSize);
+        }
+        level.stripeCount = count;
+    }
+
+    // Classify the stripe's keys into its bucket buffers, writing every buffer
+    // that fills up back to the front of the stripe as one block
+    static void classifyStripe(const Level &level, Stripe &stripe, WorkerCounters &counters)
+    {
+        const int unroll = 8;
+        int *data = level.data;
+        int *buffers = stripe.buffers.data();
+        int numBuckets = level.numBuckets;
+
+        std::fill(stripe.fill, stripe.fill + numBuckets, 0);
+        std::fill(stripe.counts, stripe.counts + numBuckets, 0);
+        int write = stripe.begin;
+        long long flushed = 0;
+
+        auto push = [&](int key, int bucket)
+        {
+            int *buffer = buffers + bucket * blockSize;
+            buffer[stripe.fill[bucket]++] = key;
+            if (stripe.fill[bucket] == blockSize)
+            {
+                std::copy(buffer, buffer + blockSize, data + write);
+                write += blockSize;
+                flushed += blockSize;
+                stripe.counts[bucket] += blockSize;
+                stripe.fill[bucket] = 0;
+            }
+        };
+
+        // Descend the tree for several keys at once to overlap their latencies
+        int i = stripe.begin;
+        for (; i + unroll <= stripe.end; i += unroll)
+        {
+            int keys[unroll];
+            int nodes[unroll];
+            for (int u = 0; u < unroll; ++u)
+            {
+                keys[u] = data[i + u];
+                nodes[u] = 1;
+            }
+            for (int depth = 0; depth < level.logBuckets; ++depth)
+            {
+                for (int u = 0; u < unroll; ++u)
+                {
+                    nodes[u] = 2 * nodes[u] + (level.tree[nodes[u]] < keys[u]);
+                }
+            }
+            for (int u = 0; u < unroll; ++u)
+            {
+                push(keys[u], bucketOf(level, nodes[u], keys[u]));
+            }
+        }
+        for (; i < stripe.end; ++i)
+        {
+            push(data[i], classify(level, data[i]));
+        }
+
+        for (int b = 0; b < numBuckets; ++b)
+        {
+            stripe.counts[b] += stripe.fill[b];
+        }
+        stripe.writeEnd = write;
+
+        long long keys = stripe.end - stripe.begin;
+        counters.comparisons += keys * (level.logBuckets + (level.equalityBuckets ? 1 : 0));
+        counters.writes += keys + flushed;
+    }
+
+    // Compute the bucket layout and pair every empty block left of the
+    // full-block boundary with a full block right of it; moving those makes
+    // [0, boundary) all full blocks. Returns the number of moves.
+    static int prepareBlocks(Level &level)
+    {
+        int stripes = level.stripeCount;
+        int fullBlocks = 0;
+        for (int t = 0; t < stripes; ++t)
+        {
+            const Stripe &stripe = level.stripes[t];
+            fullBlocks += (stripe.writeEnd - stripe.begin) / blockSize;
+        }
+        int boundary = fullBlocks * blockSize;
+
+        level.holes.clear();
+        level.fulls.clear();
+        for (int t = 0; t < stripes; ++t)
+        {
+            const Stripe &stripe = level.stripes[t];
+            for (int pos = stripe.writeEnd; pos < std::min(stripe.end, boundary); pos += blockSize)
+            {
+                level.holes.push_back(pos);
+            }
+            for (int pos = std::max(stripe.begin, boundary); pos < stripe.writeEnd; pos += blockSize)
+            {
+                level.fulls.push_back(pos);
+            }
+        }
+
+        // Bucket boundaries, and the block range of each bucket
+        level.bucketStart[0] = 0;
+        for (int b = 0; b < level.numBuckets; ++b)
+        {
+            int count = 0;
+            for (int t = 0; t < stripes; ++t)
+            {
+                count += level.stripes[t].counts[b];
+            }
+            level.bucketStart[b + 1] = level.bucketStart[b] + count;
+        }
+        for (int b = 0; b <= level.numBuckets; ++b)
+        {
+            level.blockStart[b] = alignUp(level.bucketStart[b]);
+        }
+        for (int b = 0; b < level.numBuckets; ++b)
+        {
+            int fullEnd = std::min(level.blockStart[b + 1], std::max(level.blockStart[b], boundary));
+            level.writePos[b] = level.blockStart[b];
+            level.readPos[b] = fullEnd - blockSize;
+        }
+
+        level.overflowSlot = -1;
+        return static_cast<int>(level.holes.size());
+    }
+
+    static void moveBlock(Level &level, int from, int to, WorkerCounters &counters)
+    {
+        std::copy(level.data + from, level.data + from + blockSize, level.data + to);
+        counters.writes += blockSize;
+    }
+
+    // Move full blocks into their buckets. Each thread starts at its own
+    // bucket, takes unprocessed blocks from the back of a bucket and swaps them
+    // into the next free slot of their target bucket until it reaches a slot
+    // without unprocessed data.
+    static void permuteBlocks(Level &level, int thread, int threads, WorkerCounters &counters)
+    {
+        Stripe &stripe = level.stripes[thread];
+        int *current = stripe.swapBuffers[0];
+        int *other = stripe.swapBuffers[1];
+        int numBuckets = level.numBuckets;
+        int firstBucket = numBuckets * thread / threads;
+
+        for (int i = 0; i < numBuckets; ++i)
+        {
+            int bucket = (firstBucket + i) % numBuckets;
+            while (takeBlock(level, bucket, current, counters))
+            {
+                int target = classify(level, current[0]);
+                counters.comparisons += level.logBuckets;
+
+                while (true)
+                {
+                    int slot;
+                    bool slotHasData;
+                    {
+                        std::lock_guard<std::mutex> lock(level.locks[target]);
+                        slot = level.writePos[target];
+                        level.writePos[target] += blockSize;
+                        slotHasData = slot <= level.readPos[target];
+                    }
+
+                    if (!slotHasData)
+                    {
+                        int *destination = slot + blockSize > level.size ? level.overflow : level.data + slot;
+                        if (destination == level.overflow)
+                        {
+                            level.overflowSlot = slot;
+                        }
+                        std::copy(current, current + blockSize, destination);
+                        counters.writes += blockSize;
+                        break;
+                    }
+
+                    // The slot holds an unprocessed block: swap it out and place it next
+                    std::copy(level.data + slot, level.data + slot + blockSize, other);
+                    std::copy(current, current + blockSize, level.data + slot);
+                    counters.swaps += blockSize;
+                    counters.writes += 2 * blockSize;
+                    std::swap(current, other);
+                    target = classify(level, current[0]);
+                    counters.comparisons += level.logBuckets;
+                }
+            }
+        }
+    }
+
+    // Take the last unprocessed block of a bucket. The copy happens under the
+    // lock, because the slot counts as free as soon as readPos moves past it.
+    static bool takeBlock(Level &level, int bucket, int *buffer, WorkerCounters &counters)
+    {
+        std::lock_guard<std::mutex> lock(level.locks[bucket]);
+        int slot = level.readPos[bucket];
+        if (slot < level.writePos[bucket])
+        {
+            return false;
+        }
+        level.readPos[bucket] -= blockSize;
+        std::copy(level.data + slot, level.data + slot + blockSize, buffer);
+        counters.writes += blockSize;
+        return true;
+    }
+
+    // Write back the part of the overflow block that lies inside the array
+    template <typename Counters>
+    static void restoreOverflow(Level &level, Counters &counters)
+    {
+        if (level.overflowSlot >= 0)
+        {
+            int inside = level.size - level.overflowSlot;
+            std::copy(level.overflow, level.overflow + inside, level.data + level.overflowSlot);
+            counters.writes += inside;
+        }
+    }
+
+    // Save the keys of a bucket's last block that spilled into the next bucket
+    static void saveSpill(Level &level, int bucket, WorkerCounters &counters)
+    {
+        int spillBegin = std::max(level.bucketStart[bucket + 1], level.blockStart[bucket]);
+        int spillEnd = level.writePos[bucket];
+        int *spill = level.spill.data() + bucket * blockSize;
+
+        for (int pos = spillBegin; pos < spillEnd; ++pos)
+        {
+            *spill++ = pos < level.size ? level.data[pos] : level.overflow[pos - level.overflowSlot];
+        }
+        counters.writes += std::max(0, spillEnd - spillBegin);
+    }
+
+    // Fill the gaps of a bucket around its blocks with its spilled keys and the
+    // keys left in the stripes' buffers
+    static void fillBucket(Level &level, int bucket, WorkerCounters &counters)
+    {
+        int begin = level.bucketStart[bucket];
+        int end = level.bucketStart[bucket + 1];
+        int blocksBegin = std::min(level.blockStart[bucket], end);
+        int blocksEnd = std::max(blocksBegin, std::min(level.writePos[bucket], end));
+
+        int *head = level.data + begin;
+        int *headEnd = level.data + blocksBegin;
+        int *tail = level.data + blocksEnd;
+        auto put = [&](int key)
+        {
+            if (head < headEnd)
+            {
+                *head++ = key;
+            }
+            else
+            {
+                *tail++ = key;
+            }
+        };
+
+        int spillCount = std::max(0, level.writePos[bucket] - std::max(end, level.blockStart[bucket]));
+        const int *spill = level.spill.data() + bucket * blockSize;
+        for (int i = 0; i < spillCount; ++i)
+        {
+            put(spill[i]);
+        }
+        for (int t = 0; t < level.stripeCount; ++t)
+        {
+            const Stripe &stripe = level.stripes[t];
+            const int *buffer = stripe.buffers.data() + bucket * blockSize;
+            for (int i = 0; i < stripe.fill[bucket]; ++i)
+            {
+                put(buffer[i]);
+            }
+        }
+        counters.writes += (blocksBegin - begin) + (end - blocksEnd);
+    }
+
+    static int alignUp(int offset)
+    {
+        return (offset + blockSize - 1) / blockSize * blockSize;
+    }
+
+    static double secondsSince(Clock::time_point start)
+    {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    static const char *phaseName(int phase)
+    {
+        static const char *const names[PhaseCount] = {"sampling", "classification", "permutation", "cleanup", "base case"};
+        return names[phase];
+    }
+
+    // Run body(task, worker, counters) on the pool and fold the workers'
+    // counters and phase times into the metrics
+    template <typename Body>
+    void runParallel(int tasks, Body body)
+    {
+        for (size_t w = 0; w < workers_.size(); ++w)
+        {
+            workers_[w] = WorkerCounters();
+            phaseSeconds_[w] = PhaseSeconds();
+        }
+
+        pool_.parallelFor(tasks, [&](int task, int worker)
+                          {
+            WorkerCounters &counters = workers_[worker];
+            auto start = Clock::now();
+            body(task, worker, counters);
+            counters.busyTime += secondsSince(start); });
+
+        metrics_.addWorkerCounters(workers_);
+        for (int phase = 0; phase < PhaseCount; ++phase)
+        {
+            double seconds = 0.0;
+            for (const auto &worker : phaseSeconds_)
+            {
+                seconds += worker.seconds[phase];
+            }
+            if (seconds > 0.0)
+            {
+                metrics_.addPhaseTime(phaseName(phase), seconds);
+            }
+        }
+    }
+
+    ThreadPool &pool_;
+    std::vector<int> *array_; // Pointer to the original array
+    std::unique_ptr<Level> topLevel_;                  // Shared by all threads of a parallel level
+    std::vector<std::unique_ptr<Level>> workerLevels_; // Private to each thread's sequential recursion
+    std::vector<WorkerCounters> workers_;
+    std::vector<PhaseSeconds> phaseSeconds_;
+    std::stack<Range> tasks_;         // Ranges still to be split by all threads
+    std::vector<Range> smallBuckets_; // Ranges sorted by a single thread each
+    size_t nextSmallBucket_ = 0;
+    Range current_ = {0, 0, false};
+    Step step_ = Step::Sample;
+};
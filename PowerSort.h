@@ -0,0 +1,444 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include <vector>
+#include <algorithm>
+
+// Natural merge sort that adapts to existing order (Munro and Wild's Powersort).
+// The input is scanned for ascending or strictly descending runs, short runs are
+// extended with binary insertion sort, and adjacent runs are merged in the order
+// given by the Powersort node powers, with TimSort-style galloping merges.
+// Each update() either finds one run or performs one merge.
+class PowerSort final : public SteppedSortAlgorithm<PowerSort>
+{
+public:
+    PowerSort() : SteppedSortAlgorithm("Power Sort") {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+
+        int n = static_cast<int>(array_->size());
+        minRun_ = computeMinRun(n);
+        buffer_.resize(n / 2 + 1); // A merge never buffers more than the shorter run
+        runStack_.clear();
+        runStack_.reserve(64);
+        haveCurrent_ = false;
+        haveNext_ = false;
+
+        metrics_.resetMetrics();
+        metrics_.noteAuxMemory(static_cast<long long>(buffer_.size() * sizeof(int) + runStack_.capacity() * sizeof(Run)));
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        int n = static_cast<int>(array_->size());
+
+        if (!haveCurrent_)
+        {
+            if (n == 0)
+            {
+                metrics_.isRunning = false;
+                return false;
+            }
+
+            current_ = findRun(0);
+            haveCurrent_ = true;
+            return true;
+        }
+
+        int currentEnd = current_.start + current_.length;
+        if (currentEnd < n)
+        {
+            if (!haveNext_)
+            {
+                next_ = findRun(currentEnd);
+                nextPower_ = nodePower(current_.start, current_.length, next_.length, n);
+                haveNext_ = true;
+                return true;
+            }
+
+            // Merge until the stack powers are increasing again
+            if (!runStack_.empty() && runStack_.back().power > nextPower_)
+            {
+                mergeWithStackTop();
+                return true;
+            }
+
+            current_.power = nextPower_;
+            runStack_.push_back(current_);
+            current_ = next_;
+            haveNext_ = false;
+            return true;
+        }
+
+        // Every run has been found: collapse the stack
+        if (!runStack_.empty())
+        {
+            mergeWithStackTop();
+            return true;
+        }
+
+        metrics_.isRunning = false;
+        return false;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    struct Run
+    {
+        int start;
+        int length;
+        int power;
+    };
+
+    static const int minGallop = 7;
+
+    // TimSort's minimum run length: between 32 and 64, chosen so n / minRun is
+    // close to a power of two
+    static int computeMinRun(int n)
+    {
+        int extra = 0;
+        while (n >= 64)
+        {
+            extra |= n & 1;
+            n >>= 1;
+        }
+        return n + extra;
+    }
+
+    // Powersort node power of the boundary between two adjacent runs: the first
+    // bit at which the runs' normalised midpoints differ
+    static int nodePower(int start1, int length1, int length2, int n)
+    {
+        long long a = 2LL * start1 + length1; // 2 * midpoint of run 1
+        long long b = a + length1 + length2;  // 2 * midpoint of run 2
+        long long twoN = 2LL * n;
+
+        int power = 0;
+        while (true)
+        {
+            ++power;
+            a <<= 1;
+            b <<= 1;
+
+            bool bitA = a >= twoN;
+            bool bitB = b >= twoN;
+            if (bitA != bitB)
+            {
+                return power;
+            }
+            if (bitA)
+            {
+                a -= twoN;
+                b -= twoN;
+            }
+        }
+    }
+
+    // Find the run starting at start, reversing it if strictly descending and
+    // extending it to minRun_ elements with binary insertion sort
+    Run findRun(int start)
+    {
+        int *a = array_->data();
+        int n = static_cast<int>(array_->size());
+        int end = start + 1;
+
+        if (end < n)
+        {
+            metrics_.comparisons++;
+            if (a[end] < a[start])
+            {
+                ++end;
+                while (end < n && a[end] < a[end - 1])
+                {
+                    metrics_.comparisons++;
+                    ++end;
+                }
+                std::reverse(a + start, a + end);
+                metrics_.swaps += (end - start) / 2;
+                metrics_.writes += end - start;
+            }
+            else
+            {
+                ++end;
+                while (end < n && !(a[end] < a[end - 1]))
+                {
+                    metrics_.comparisons++;
+                    ++end;
+                }
+            }
+        }
+
+        int forcedEnd = std::min(start + minRun_, n);
+        if (end < forcedEnd)
+        {
+            binaryInsertionSort(a + start, a + end, a + forcedEnd, metrics_);
+            end = forcedEnd;
+        }
+
+        return {start, end - start, 0};
+    }
+
+    void mergeWithStackTop()
+    {
+        Run top = runStack_.back();
+        runStack_.pop_back();
+
+        mergeRuns(array_->data() + top.start, top.length, current_.length);
+        current_.start = top.start;
+        current_.length += top.length;
+    }
+
+    // Merge the adjacent sorted runs [base, base + length1) and
+    // [base + length1, base + length1 + length2)
+    void mergeRuns(int *base, int length1, int length2)
+    {
+        int *base1 = base;
+        int *base2 = base + length1;
+
+        // Keys of run 1 not greater than run 2's first key are already in place
+        int skip = gallopRight(*base2, base1, length1);
+        base1 += skip;
+        length1 -= skip;
+        if (length1 == 0)
+        {
+            return;
+        }
+
+        // Keys of run 2 not smaller than run 1's last key are already in place
+        length2 = gallopLeft(base1[length1 - 1], base2, length2);
+        if (length2 == 0)
+        {
+            return;
+        }
+
+        if (length1 <= length2)
+        {
+            mergeLow(base1, length1, base2, length2);
+        }
+        else
+        {
+            mergeHigh(base1, length1, base2, length2);
+        }
+    }
+
+    // Exponential search from the front, then binary search in the bracket.
+    // gallopLeft returns the lower bound of key, gallopRight the upper bound.
+    int gallopLeft(int key, const int *base, int length)
+    {
+        return gallop(key, base, length, [](int a, int b)
+                      { return a < b; });
+    }
+
+    int gallopRight(int key, const int *base, int length)
+    {
+        return gallop(key, base, length, [](int a, int b)
+                      { return !(b < a); });
+    }
+
+    template <typename Before>
+    int gallop(int key, const int *base, int length, Before before)
+    {
+        int bound = 1;
+        while (bound <= length)
+        {
+            metrics_.comparisons++;
+            if (!before(base[bound - 1], key))
+            {
+                break;
+            }
+            bound *= 2;
+        }
+
+        const int *low = base + bound / 2;
+        const int *high = base + std::min(bound, length);
+        return static_cast<int>(std::partition_point(low, high, [&](int value)
+                                                     {
+                                                         metrics_.comparisons++;
+                                                         return before(value, key); }) -
+                                base);
+    }
+
+    // The same searches starting from the back of the range
+    int gallopLeftFromEnd(int key, const int *base, int length)
+    {
+        return gallopFromEnd(key, base, length, [](int a, int b)
+                             { return a < b; });
+    }
+
+    int gallopRightFromEnd(int key, const int *base, int length)
+    {
+        return gallopFromEnd(key, base, length, [](int a, int b)
+                             { return !(b < a); });
+    }
+
+    template <typename Before>
+    int gallopFromEnd(int key, const int *base, int length, Before before)
+    {
+        int bound = 1;
+        while (bound <= length)
+        {
+            metrics_.comparisons++;
+            if (before(base[length - bound], key))
+            {
+                break;
+            }
+            bound *= 2;
+        }
+
+        const int *low = base + length - std::min(bound, length);
+        const int *high = base + length - bound / 2;
+        return static_cast<int>(std::partition_point(low, high, [&](int value)
+                                                     {
+                                                         metrics_.comparisons++;
+                                                         return before(value, key); }) -
+                                base);
+    }
+
+    // Merge with run 1 (the shorter) copied to the buffer, filling from the front
+    void mergeLow(int *base1, int length1, int *base2, int length2)
+    {
+        int *tmp = buffer_.data();
+        std::copy(base1, base1 + length1, tmp);
+        metrics_.writes += length1 + (base2 + length2 - base1);
+
+        const int *cursor1 = tmp;
+        const int *end1 = tmp + length1;
+        int *cursor2 = base2;
+        int *end2 = base2 + length2;
+        int *dest = base1;
+
+        while (cursor1 < end1 && cursor2 < end2)
+        {
+            // One key at a time until one run wins minGallop times in a row
+            int wins1 = 0;
+            int wins2 = 0;
+            while (cursor1 < end1 && cursor2 < end2 && wins1 < minGallop && wins2 < minGallop)
+            {
+                metrics_.comparisons++;
+                if (*cursor2 < *cursor1)
+                {
+                    *dest++ = *cursor2++;
+                    metrics_.swaps++;
+                    ++wins2;
+                    wins1 = 0;
+                }
+                else
+                {
+                    *dest++ = *cursor1++;
+                    ++wins1;
+                    wins2 = 0;
+                }
+            }
+
+            // Galloping: copy whole stretches located by exponential search
+            while (cursor1 < end1 && cursor2 < end2)
+            {
+                int count1 = gallopRight(*cursor2, cursor1, static_cast<int>(end1 - cursor1));
+                dest = std::copy(cursor1, cursor1 + count1, dest);
+                cursor1 += count1;
+                if (cursor1 == end1)
+                {
+                    break;
+                }
+
+                int count2 = gallopLeft(*cursor1, cursor2, static_cast<int>(end2 - cursor2));
+                dest = std::copy(cursor2, cursor2 + count2, dest);
+                cursor2 += count2;
+
+                if (count1 < minGallop && count2 < minGallop)
+                {
+                    break;
+                }
+            }
+        }
+
+        // Whatever remains of run 2 is already in place
+        std::copy(cursor1, end1, dest);
+    }
+
+    // Merge with run 2 (the shorter) copied to the buffer, filling from the back
+    void mergeHigh(int *base1, int length1, int *base2, int length2)
+    {
+        const int *tmp = buffer_.data();
+        std::copy(base2, base2 + length2, buffer_.data());
+        metrics_.writes += length2 + (base2 + length2 - base1);
+
+        int *cursor1 = base1 + length1;
+        const int *cursor2 = tmp + length2;
+        int *dest = base2 + length2;
+
+        while (cursor1 > base1 && cursor2 > tmp)
+        {
+            int wins1 = 0;
+            int wins2 = 0;
+            while (cursor1 > base1 && cursor2 > tmp && wins1 < minGallop && wins2 < minGallop)
+            {
+                metrics_.comparisons++;
+                if (*(cursor2 - 1) < *(cursor1 - 1))
+                {
+                    *--dest = *--cursor1;
+                    metrics_.swaps++;
+                    ++wins1;
+                    wins2 = 0;
+                }
+                else
+                {
+                    *--dest = *--cursor2;
+                    ++wins2;
+                    wins1 = 0;
+                }
+            }
+
+            while (cursor1 > base1 && cursor2 > tmp)
+            {
+                // Keys of run 1 greater than run 2's largest remaining key
+                int remaining1 = static_cast<int>(cursor1 - base1);
+                int count1 = remaining1 - gallopRightFromEnd(*(cursor2 - 1), base1, remaining1);
+                dest = std::copy_backward(cursor1 - count1, cursor1, dest);
+                cursor1 -= count1;
+                if (cursor1 == base1)
+                {
+                    break;
+                }
+
+                // Keys of run 2 not smaller than run 1's largest remaining key
+                int remaining2 = static_cast<int>(cursor2 - tmp);
+                int count2 = remaining2 - gallopLeftFromEnd(*(cursor1 - 1), tmp, remaining2);
+                dest = std::copy_backward(cursor2 - count2, cursor2, dest);
+                cursor2 -= count2;
+
+                if (count1 < minGallop && count2 < minGallop)
+                {
+                    break;
+                }
+            }
+        }
+
+        // Whatever remains of run 1 is already in place
+        std::copy(tmp, cursor2, dest - (cursor2 - tmp));
+    }
+
+    std::vector<int> *array_; // Pointer to the original array
+    std::vector<int> buffer_; // Merge scratch space, half the array
+    std::vector<Run> runStack_;
+    Run current_ = {0, 0, 0};
+    Run next_ = {0, 0, 0};
+    int nextPower_ = 0;
+    bool haveCurrent_ = false;
+    bool haveNext_ = false;
+    int minRun_ = 32;
+};
@@ -1,22 +1,227 @@
 #pragma once
 
 #include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include "SortingNetworks.h"
 #include <vector>
 #include <stack>
+#include <string>
+#include <cstdint>
+#include <tuple>
 
-class QuickSort : public SortAlgorithm
+// Quick Sort assembled from three compile-time policies: how the pivot is
+// chosen, how the range is partitioned around it and how small ranges are
+// finished. Every combination is its own class, so the hot loops contain no
+// virtual calls and no branches on the configuration. "Quick Sort" itself is
+// the classic last-key pivot with a Lomuto partition; the other combinations
+// are registered as "Quick Sort [pivot/partition/base case]" variants.
+
+// Pivot policies move the chosen pivot to *first
+
+struct LastPivot
+{
+    static constexpr const char *name = "Last";
+
+    template <typename Counters>
+    void select(int *first, int *last, Counters &counters)
+    {
+        std::swap(*first, *(last - 1));
+        counters.swaps++;
+        counters.writes += 2;
+    }
+};
+
+struct MedianOfThreePivot
+{
+    static constexpr const char *name = "Median3";
+
+    template <typename Counters>
+    void select(int *first, int *last, Counters &counters)
+    {
+        // The median of the first, middle and last keys lands in *first
+        sortThree(first + (last - first) / 2, first, last - 1, counters);
+    }
+};
+
+struct NintherPivot
 {
+    static constexpr const char *name = "Ninther";
+
+    template <typename Counters>
+    void select(int *first, int *last, Counters &counters)
+    {
+        selectPivotToFront(first, last, counters);
+    }
+};
+
+struct RandomPivot
+{
+    static constexpr const char *name = "Random";
+
+    template <typename Counters>
+    void select(int *first, int *last, Counters &counters)
+    {
+        // xorshift32, reseeded with the algorithm so runs are repeatable
+        state_ ^= state_ << 13;
+        state_ ^= state_ >> 17;
+        state_ ^= state_ << 5;
+        std::ptrdiff_t index = static_cast<std::ptrdiff_t>((static_cast<std::uint64_t>(state_) * static_cast<std::uint64_t>(last - first)) >> 32);
+
+        std::swap(*first, first[index]);
+        counters.swaps++;
+        counters.writes += 2;
+    }
+
+private:
+    std::uint32_t state_ = 2463534242u;
+};
+
+// Partition schemes split [first, last) around the pivot in *first; only
+// [first, leftEnd) and [rightBegin, last) still need sorting
+
+struct PartitionSplit
+{
+    int *leftEnd;
+    int *rightBegin;
+};
+
+struct LomutoPartition
+{
+    static constexpr const char *name = "Lomuto";
+
+    template <typename Counters>
+    static PartitionSplit partition(int *first, int *last, Counters &counters)
+    {
+        int pivot = *first;
+        int *smallerEnd = first;
+
+        for (int *key = first + 1; key < last; ++key)
+        {
+            counters.comparisons++;
+            if (*key <= pivot)
+            {
+                std::swap(*++smallerEnd, *key);
+                counters.swaps++;
+                counters.writes += 2;
+            }
+        }
+
+        std::swap(*first, *smallerEnd);
+        counters.swaps++;
+        counters.writes += 2;
+        return {smallerEnd, smallerEnd + 1};
+    }
+};
+
+struct HoarePartition
+{
+    static constexpr const char *name = "Hoare";
+
+    template <typename Counters>
+    static PartitionSplit partition(int *first, int *last, Counters &counters)
+    {
+        int *pivot = partitionAroundFront(first, last, counters);
+        return {pivot, pivot + 1};
+    }
+};
+
+struct BlockPartition
+{
+    static constexpr const char *name = "Block";
+
+    template <typename Counters>
+    static PartitionSplit partition(int *first, int *last, Counters &counters)
+    {
+        // partitionBlock() needs a key no smaller than the pivot after it,
+        // which selectPivotToFront() leaves but the other pivots do not; make
+        // sure the last key is one, swapping it in as the pivot if smaller
+        counters.comparisons++;
+        if (*(last - 1) < *first)
+        {
+            std::swap(*first, *(last - 1));
+            counters.swaps++;
+            counters.writes += 2;
+        }
+
+        int *pivot = partitionBlock(first, last, counters);
+        return {pivot, pivot + 1};
+    }
+};
+
+struct ThreeWayPartition
+{
+    static constexpr const char *name = "ThreeWay";
+
+    template <typename Counters>
+    static PartitionSplit partition(int *first, int *last, Counters &counters)
+    {
+        auto [lessEnd, greaterBegin] = partitionThreeWay(first, last, counters);
+        return {lessEnd, greaterBegin};
+    }
+};
+
+// Base cases finish ranges of up to threshold keys in one step
+
+struct NoBaseCase
+{
+    static constexpr const char *name = "None";
+    static constexpr std::ptrdiff_t threshold = 1;
+
+    template <typename Counters>
+    static void sort(int *, int *, Counters &)
+    {
+    }
+};
+
+struct InsertionBaseCase
+{
+    static constexpr const char *name = "Insertion";
+    static constexpr std::ptrdiff_t threshold = 16;
+
+    template <typename Counters>
+    static void sort(int *first, int *last, Counters &counters)
+    {
+        insertionSort(first, last, counters);
+    }
+};
+
+struct NetworkBaseCase
+{
+    static constexpr const char *name = "Network";
+    static constexpr std::ptrdiff_t threshold = 16;
+
+    template <typename Counters>
+    static void sort(int *first, int *last, Counters &counters)
+    {
+        networkSort(first, last, counters);
+    }
+};
+
+// One partition is processed per update(); the larger side is pushed first so
+// the stack stays O(log n) deep
+template <typename Pivot, typename Partition, typename BaseCase>
+class QuickSortVariant final : public SteppedSortAlgorithm<QuickSortVariant<Pivot, Partition, BaseCase>>
+{
+    using Base = SteppedSortAlgorithm<QuickSortVariant<Pivot, Partition, BaseCase>>;
+    using Base::metrics_;
+
 public:
-    QuickSort() : SortAlgorithm("Quick Sort") {}
+    explicit QuickSortVariant(const std::string &name = getVariantName()) : Base(name) {}
+
+    static std::string getVariantName()
+    {
+        return std::string("Quick Sort [") + Pivot::name + "/" + Partition::name + "/" + BaseCase::name + "]";
+    }
 
     void initialize(std::vector<int> &array) override
     {
         array_ = &array; // Store a reference to the original array
-        sortStack_ = std::stack<std::pair<int, int>>();
+        sortStack_ = std::stack<Range>();
+        pivot_ = Pivot();
 
-        if (!array_->empty())
+        if (array_->size() > 1)
         {
-            sortStack_.push({0, static_cast<int>(array_->size() - 1)});
+            sortStack_.push({0, static_cast<int>(array_->size())});
         }
 
         metrics_.resetMetrics();
@@ -33,19 +238,30 @@ public:
         }
 
         // Get the next partition to process
-        auto &top = sortStack_.top();
-        int low = top.first;
-        int high = top.second;
+        Range range = sortStack_.top();
         sortStack_.pop();
 
-        if (low < high)
+        int *data = array_->data();
+        int *first = data + range.first;
+        int *last = data + range.last;
+
+        if (last - first <= BaseCase::threshold)
+        {
+            BaseCase::sort(first, last, metrics_);
+        }
+        else
         {
-            // Perform partitioning
-            int pivot = partition(low, high);
+            pivot_.select(first, last, metrics_);
+            PartitionSplit split = Partition::partition(first, last, metrics_);
 
-            // Push sub-partitions onto the stack
-            sortStack_.push({low, pivot - 1});
-            sortStack_.push({pivot + 1, high});
+            Range left = {range.first, static_cast<int>(split.leftEnd - data)};
+            Range right = {static_cast<int>(split.rightBegin - data), range.last};
+            if (left.last - left.first < right.last - right.first)
+            {
+                std::swap(left, right);
+            }
+            pushRange(left);
+            pushRange(right);
         }
 
         return !sortStack_.empty();
@@ -57,26 +273,56 @@ public:
     }
 
 private:
-    int partition(int low, int high)
+    struct Range
     {
-        int pivot = (*array_)[high];
-        int i = (low - 1);
+        int first;
+        int last;
+    };
 
-        for (int j = low; j <= high - 1; j++)
+    void pushRange(const Range &range)
+    {
+        if (range.last - range.first > 1)
         {
-            metrics_.comparisons++;
-            if ((*array_)[j] <= pivot)
-            {
-                i++;
-                std::swap((*array_)[i], (*array_)[j]);
-                metrics_.swaps++;
-            }
+            sortStack_.push(range);
         }
-        std::swap((*array_)[i + 1], (*array_)[high]);
-        metrics_.swaps++;
-        return (i + 1);
     }
 
     std::vector<int> *array_; // Pointer to the original array
-    std::stack<std::pair<int, int>> sortStack_;
-};
\ No newline at end of file
+    std::stack<Range> sortStack_;
+    Pivot pivot_;
+};
+
+// The classic configuration, registered as "Quick Sort"
+using QuickSort = QuickSortVariant<LastPivot, LomutoPartition, NetworkBaseCase>;
+
+// The policy sets the generated variants are drawn from
+using PivotPolicies = std::tuple<LastPivot, MedianOfThreePivot, NintherPivot, RandomPivot>;
+using PartitionSchemes = std::tuple<LomutoPartition, HoarePartition, BlockPartition, ThreeWayPartition>;
+using BaseCases = std::tuple<NoBaseCase, InsertionBaseCase, NetworkBaseCase>;
+
+template <typename T>
+struct TypeTag
+{
+    using type = T;
+};
+
+template <typename... Types, typename Visit>
+void forEachType(std::tuple<Types...> *, Visit &&visit)
+{
+    (visit(TypeTag<Types>{}), ...);
+}
+
+// Call visit(TypeTag<QuickSortVariant<...>>()) for every combination of the
+// policies, pivot policy outermost
+template <typename Visit>
+void forEachQuickSortVariant(Visit &&visit)
+{
+    forEachType(static_cast<PivotPolicies *>(nullptr), [&](auto pivot)
+                { forEachType(static_cast<PartitionSchemes *>(nullptr), [&](auto partition)
+                              { forEachType(static_cast<BaseCases *>(nullptr), [&](auto baseCase)
+                                            {
+                    using Variant = QuickSortVariant<typename decltype(pivot)::type,
+                                                     typename decltype(partition)::type,
+                                                     typename decltype(baseCase)::type>;
+                    visit(TypeTag<Variant>()); }); }); });
+}
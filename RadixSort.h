@@ -0,0 +1,161 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+
+// Least-significant-digit radix sort on the keys' bit patterns: three stable
+// counting passes over 11-bit digits (11 + 11 + 10 bits), so each histogram
+// fits in L1. The sign bit is flipped so negative keys order first. One fused
+// pass counts all three digits at once, and a pass whose digit is the same for
+// every key is skipped. The first update() builds the histograms, each later
+// update() scatters one digit between the array and a persistent buffer.
+class RadixSort final : public SteppedSortAlgorithm<RadixSort>
+{
+public:
+    RadixSort() : SteppedSortAlgorithm("Radix Sort") {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        buffer_.resize(array_->size());
+        source_ = array_->data();
+        dest_ = buffer_.data();
+        pass_ = -1;
+
+        metrics_.resetMetrics();
+        metrics_.noteAuxMemory(static_cast<long long>(buffer_.size() * sizeof(int)));
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning)
+        {
+            return false;
+        }
+
+        if (pass_ < 0)
+        {
+            buildHistograms();
+            pass_ = 0;
+        }
+        else
+        {
+            // Skip passes whose digit is constant
+            while (pass_ < passCount && trivial_[pass_])
+            {
+                ++pass_;
+            }
+            if (pass_ < passCount)
+            {
+                scatter(pass_);
+                std::swap(source_, dest_);
+                ++pass_;
+            }
+        }
+
+        if (pass_ < passCount && !allTrivialFrom(pass_))
+        {
+            return true;
+        }
+
+        // An odd number of passes leaves the result in the buffer
+        if (source_ != array_->data())
+        {
+            std::copy(source_, source_ + array_->size(), array_->data());
+            metrics_.writes += static_cast<long long>(array_->size());
+        }
+        metrics_.isRunning = false;
+        return false;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    static const int digitBits = 11;
+    static const int radix = 1 << digitBits;
+    static const int passCount = 3; // ceil(32 / digitBits)
+
+    static uint32_t toUnsigned(int key)
+    {
+        return static_cast<uint32_t>(key) ^ 0x80000000u;
+    }
+
+    static uint32_t digit(uint32_t bits, int pass)
+    {
+        return (bits >> (pass * digitBits)) & (radix - 1);
+    }
+
+    // Count the digits of every pass in a single read of the array
+    void buildHistograms()
+    {
+        for (auto &histogram : histograms_)
+        {
+            std::fill(histogram, histogram + radix, 0);
+        }
+
+        const int *data = array_->data();
+        size_t n = array_->size();
+        for (size_t i = 0; i < n; ++i)
+        {
+            uint32_t bits = toUnsigned(data[i]);
+            ++histograms_[0][digit(bits, 0)];
+            ++histograms_[1][digit(bits, 1)];
+            ++histograms_[2][digit(bits, 2)];
+        }
+
+        // A pass is trivial when every key has the same digit
+        for (int pass = 0; pass < passCount; ++pass)
+        {
+            const unsigned int *histogram = histograms_[pass];
+            trivial_[pass] = n == 0 || std::find(histogram, histogram + radix, n) != histogram + radix;
+        }
+    }
+
+    bool allTrivialFrom(int pass) const
+    {
+        for (; pass < passCount; ++pass)
+        {
+            if (!trivial_[pass])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Stable scatter of source_ into dest_ by one digit
+    void scatter(int pass)
+    {
+        size_t offsets[radix];
+        size_t sum = 0;
+        for (int d = 0; d < radix; ++d)
+        {
+            offsets[d] = sum;
+            sum += histograms_[pass][d];
+        }
+
+        size_t n = array_->size();
+        int shift = pass * digitBits;
+        for (size_t i = 0; i < n; ++i)
+        {
+            int key = source_[i];
+            dest_[offsets[(toUnsigned(key) >> shift) & (radix - 1)]++] = key;
+        }
+        metrics_.writes += static_cast<long long>(n);
+    }
+
+    std::vector<int> *array_; // Pointer to the original array
+    std::vector<int> buffer_; // Persistent scratch space, the other half of the ping-pong
+    int *source_ = nullptr;
+    int *dest_ = nullptr;
+    unsigned int histograms_[passCount][radix];
+    bool trivial_[passCount];
+    int pass_ = -1; // -1 until the histograms are built
+};
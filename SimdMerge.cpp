@@ -0,0 +1,219 @@
+#include "SimdMerge.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SIMD_MERGE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+#endif
+
+namespace
+{
+    // Take the smaller head without a branch; ties come from a
+    int *mergeScalar(const int *a, const int *aEnd, const int *b, const int *bEnd, int *out)
+    {
+        while (a < aEnd && b < bEnd)
+        {
+            int x = *a;
+            int y = *b;
+            bool takeB = y < x;
+            *out++ = takeB ? y : x;
+            a += !takeB;
+            b += takeB;
+        }
+        out = std::copy(a, aEnd, out);
+        return std::copy(b, bEnd, out);
+    }
+
+    // Merge a few keys into a long run: each key's place is found by binary
+    // search and the stretch of the run before it is copied whole
+    int *mergeFew(const int *few, const int *fewEnd, const int *run, const int *runEnd, int *out)
+    {
+        for (; few < fewEnd; ++few)
+        {
+            const int *stop = std::upper_bound(run, runEnd, *few);
+            out = std::copy(run, stop, out);
+            run = stop;
+            *out++ = *few;
+        }
+        return std::copy(run, runEnd, out);
+    }
+
+    // Finish a vector merge. held are the keys left in the register, at
+    // most 16; at least one of the runs has fewer keys left than a vector.
+    int *mergeTail(const int *held, const int *heldEnd, const int *a, const int *aEnd, const int *b, const int *bEnd, int *out)
+    {
+        const int *shortRun = a;
+        const int *shortEnd = aEnd;
+        const int *longRun = b;
+        const int *longEnd = bEnd;
+        if (aEnd - a > bEnd - b)
+        {
+            std::swap(shortRun, longRun);
+            std::swap(shortEnd, longEnd);
+        }
+
+        int few[32];
+        int *fewEnd = mergeScalar(held, heldEnd, shortRun, shortEnd, few);
+        if (longEnd - longRun <= 64)
+        {
+            return mergeScalar(few, fewEnd, longRun, longEnd, out);
+        }
+        return mergeFew(few, fewEnd, longRun, longEnd, out);
+    }
+
+#ifdef SIMD_MERGE_X86
+    // Sort a bitonic vector: compare-exchange lanes 4, 2 and 1 apart
+    TARGET_AVX2 inline __m256i sortBitonicAvx2(__m256i keys)
+    {
+        __m256i other = _mm256_permute2x128_si256(keys, keys, 1);
+        keys = _mm256_blend_epi32(_mm256_min_epi32(keys, other), _mm256_max_epi32(keys, other), 0xF0);
+        other = _mm256_shuffle_epi32(keys, _MM_SHUFFLE(1, 0, 3, 2));
+        keys = _mm256_blend_epi32(_mm256_min_epi32(keys, other), _mm256_max_epi32(keys, other), 0xCC);
+        other = _mm256_shuffle_epi32(keys, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm256_blend_epi32(_mm256_min_epi32(keys, other), _mm256_max_epi32(keys, other), 0xAA);
+    }
+
+    // Merge two sorted vectors: afterwards low holds the 8 smallest keys and
+    // high the 8 largest, both sorted
+    TARGET_AVX2 inline void bitonicMergeAvx2(__m256i &low, __m256i &high)
+    {
+        // low followed by high reversed is bitonic
+        __m256i reversed = _mm256_permutevar8x32_epi32(high, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+        __m256i smaller = _mm256_min_epi32(low, reversed);
+        __m256i larger = _mm256_max_epi32(low, reversed);
+        low = sortBitonicAvx2(smaller);
+        high = sortBitonicAvx2(larger);
+    }
+
+    TARGET_AVX2 int *mergeAvx2(const int *a, const int *aEnd, const int *b, const int *bEnd, int *out)
+    {
+        const int lanes = 8;
+        if (aEnd - a < lanes || bEnd - b < lanes)
+        {
+            return mergeTail(a, a, a, aEnd, b, bEnd, out);
+        }
+
+        __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+        __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+        a += lanes;
+        b += lanes;
+
+        for (;;)
+        {
+            bitonicMergeAvx2(low, high);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), low);
+            out += lanes;
+
+            if (aEnd - a < lanes || bEnd - b < lanes)
+            {
+                break;
+            }
+
+            // The next keys out are among high and the vector starting at the
+            // smaller head
+            bool takeA = *a <= *b;
+            low = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(takeA ? a : b));
+            a += takeA ? lanes : 0;
+            b += takeA ? 0 : lanes;
+        }
+
+        alignas(32) int held[lanes];
+        _mm256_store_si256(reinterpret_cast<__m256i *>(held), high);
+        return mergeTail(held, held + lanes, a, aEnd, b, bEnd, out);
+    }
+
+    // Compare-exchange keys with other, a shuffle of them; upper marks the
+    // lanes that keep the larger key
+    TARGET_AVX512 inline __m512i exchangeAvx512(__m512i keys, __m512i other, __mmask16 upper)
+    {
+        __m512i smaller = _mm512_maskz_min_epi32(0xFFFF, keys, other);
+        return _mm512_mask_max_epi32(smaller, upper, keys, other);
+    }
+
+    // The zero-masking forms throughout sidestep GCC 12's uninitialised-value
+    // warning for the plain ones
+    TARGET_AVX512 inline __m512i sortBitonicAvx512(__m512i keys)
+    {
+        keys = exchangeAvx512(keys, _mm512_maskz_shuffle_i64x2(0xFF, keys, keys, _MM_SHUFFLE(1, 0, 3, 2)), 0xFF00);
+        keys = exchangeAvx512(keys, _mm512_maskz_shuffle_i64x2(0xFF, keys, keys, _MM_SHUFFLE(2, 3, 0, 1)), 0xF0F0);
+        keys = exchangeAvx512(keys, _mm512_maskz_shuffle_epi32(0xFFFF, keys, _MM_PERM_BADC), 0xCCCC);
+        return exchangeAvx512(keys, _mm512_maskz_shuffle_epi32(0xFFFF, keys, _MM_PERM_CDAB), 0xAAAA);
+    }
+
+    TARGET_AVX512 inline void bitonicMergeAvx512(__m512i &low, __m512i &high)
+    {
+        const __m512i reverse = _mm512_setr_epi32(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        __m512i reversed = _mm512_maskz_permutexvar_epi32(0xFFFF, reverse, high);
+        __m512i smaller = _mm512_maskz_min_epi32(0xFFFF, low, reversed);
+        __m512i larger = _mm512_maskz_max_epi32(0xFFFF, low, reversed);
+        low = sortBitonicAvx512(smaller);
+        high = sortBitonicAvx512(larger);
+    }
+
+    TARGET_AVX512 int *mergeAvx512(const int *a, const int *aEnd, const int *b, const int *bEnd, int *out)
+    {
+        const int lanes = 16;
+        if (aEnd - a < lanes || bEnd - b < lanes)
+        {
+            return mergeTail(a, a, a, aEnd, b, bEnd, out);
+        }
+
+        __m512i low = _mm512_loadu_si512(a);
+        __m512i high = _mm512_loadu_si512(b);
+        a += lanes;
+        b += lanes;
+
+        for (;;)
+        {
+            bitonicMergeAvx512(low, high);
+            _mm512_storeu_si512(out, low);
+            out += lanes;
+
+            if (aEnd - a < lanes || bEnd - b < lanes)
+            {
+                break;
+            }
+
+            bool takeA = *a <= *b;
+            low = _mm512_loadu_si512(takeA ? a : b);
+            a += takeA ? lanes : 0;
+            b += takeA ? 0 : lanes;
+        }
+
+        alignas(64) int held[lanes];
+        _mm512_store_si512(held, high);
+        return mergeTail(held, held + lanes, a, aEnd, b, bEnd, out);
+    }
+#endif
+}
+
+int *mergeSorted(const int *a, const int *aEnd, const int *b, const int *bEnd, int *out)
+{
+    return mergeSorted(a, aEnd, b, bEnd, out, detectSimdLevel());
+}
+
+int *mergeSorted(const int *a, const int *aEnd, const int *b, const int *bEnd, int *out, SimdLevel level)
+{
+    if (static_cast<int>(level) > static_cast<int>(detectSimdLevel()))
+    {
+        level = detectSimdLevel();
+    }
+
+    switch (level)
+    {
+#ifdef SIMD_MERGE_X86
+    case SimdLevel::AVX512:
+        return mergeAvx512(a, aEnd, b, bEnd, out);
+    case SimdLevel::AVX2:
+        return mergeAvx2(a, aEnd, b, bEnd, out);
+#endif
+    default:
+        return mergeScalar(a, aEnd, b, bEnd, out);
+    }
+}
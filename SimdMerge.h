@@ -0,0 +1,47 @@
+#pragma once
+
+#include "SimdPartition.h"
+#include <algorithm>
+
+// Vectorised merge kernel. Two registers of 8 (AVX2) or 16 (AVX-512) keys are
+// merged with a bitonic merge network; the smaller half is stored and the run
+// with the smaller next key refills the other register, so each iteration
+// outputs a whole vector with a single data-dependent branch. The level is
+// picked at run time like the partition kernel's, with a branch-free scalar
+// loop as the fallback.
+
+// Merge the sorted runs [a, aEnd) and [b, bEnd) into out, which must not
+// overlap them, and return the end of the output. Equal keys are
+// interchangeable, so the order between the runs' equal keys is not kept.
+int *mergeSorted(const int *a, const int *aEnd, const int *b, const int *bEnd, int *out);
+
+// Same with an explicit level; levels above detectSimdLevel() run the best
+// supported one instead
+int *mergeSorted(const int *a, const int *aEnd, const int *b, const int *bEnd, int *out, SimdLevel level);
+
+// What a one-key-at-a-time merge of the same runs would have counted
+struct MergeCount
+{
+    long long comparisons;
+    long long fromSecond; // Keys taken from b while a still had keys
+};
+
+// The run whose last key comes first is used up first and the rest of the
+// other one is copied without comparisons, so both counts follow from where
+// that last key falls in the other run. Ties are taken from a first.
+inline MergeCount countMerge(const int *a, const int *aEnd, const int *b, const int *bEnd)
+{
+    if (a == aEnd || b == bEnd)
+    {
+        return {0, 0};
+    }
+
+    if (*(aEnd - 1) <= *(bEnd - 1))
+    {
+        long long before = std::lower_bound(b, bEnd, *(aEnd - 1)) - b;
+        return {(aEnd - a) + before, before};
+    }
+
+    long long before = std::upper_bound(a, aEnd, *(bEnd - 1)) - a;
+    return {before + (bEnd - b), bEnd - b};
+}
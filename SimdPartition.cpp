@@ -0,0 +1,375 @@
+#include "SimdPartition.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SIMD_PARTITION_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+// MSVC emits any intrinsic without per-function options
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#define TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define TARGET_AVX512 __attribute__((target("avx512f,popcnt")))
+#endif
+#endif
+
+namespace
+{
+    // Hand out the buffered keys: smaller ones at writeLeft, the others below
+    // writeRight. The free slots between the cursors match the key count.
+    int *distribute(const int *keys, const int *keysEnd, int *writeLeft, int *writeRight, int pivot)
+    {
+        for (; keys < keysEnd; ++keys)
+        {
+            if (*keys < pivot)
+            {
+                *writeLeft++ = *keys;
+            }
+            else
+            {
+                *--writeRight = *keys;
+            }
+        }
+        return writeLeft;
+    }
+
+    // The vector kernels' scheme with a width of one key: the first and last
+    // keys are held back, so there is always a free slot on both sides and each
+    // key can be written to both without a branch
+    int *partitionScalar(int *first, int *last, int pivot)
+    {
+        if (last - first < 2)
+        {
+            return first + (first < last && *first < pivot);
+        }
+
+        int saved[2] = {*first, *(last - 1)};
+        int *readLeft = first + 1;
+        int *readRight = last - 1;
+        int *writeLeft = first;
+        int *writeRight = last;
+
+        while (readLeft < readRight)
+        {
+            // Read from the side with less free space
+            int key;
+            if (readLeft - writeLeft <= writeRight - readRight)
+            {
+                key = *readLeft++;
+            }
+            else
+            {
+                key = *--readRight;
+            }
+
+            bool smaller = key < pivot;
+            *writeLeft = key;
+            *(writeRight - 1) = key;
+            writeLeft += smaller;
+            writeRight -= !smaller;
+        }
+
+        return distribute(saved, saved + 2, writeLeft, writeRight, pivot);
+    }
+
+#ifdef SIMD_PARTITION_X86
+    // For each 8-bit mask of keys < pivot: the lane order that moves the
+    // selected lanes to the front, both groups in their original order, as
+    // eight 4-bit lane indices
+    constexpr std::array<uint32_t, 256> buildPermutations()
+    {
+        std::array<uint32_t, 256> table{};
+        for (int mask = 0; mask < 256; ++mask)
+        {
+            uint32_t packed = 0;
+            int slot = 0;
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                if (mask & (1 << lane))
+                {
+                    packed |= static_cast<uint32_t>(lane) << (4 * slot++);
+                }
+            }
+            for (int lane = 0; lane < 8; ++lane)
+            {
+                if (!(mask & (1 << lane)))
+                {
+                    packed |= static_cast<uint32_t>(lane) << (4 * slot++);
+                }
+            }
+            table[mask] = packed;
+        }
+        return table;
+    }
+
+    constexpr std::array<uint32_t, 256> permutations = buildPermutations();
+
+    // Split eight keys: the smaller ones are stored from writeLeft on, the
+    // others end at writeRight. Both stores write all eight lanes, which the
+    // caller's free space on each side allows. Returns the smaller count.
+    TARGET_AVX2 inline int storeAvx2(__m256i keys, __m256i pivots, int *writeLeft, int *writeRight)
+    {
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(pivots, keys)));
+        __m256i lanes = _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(permutations[mask])),
+                                          _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28));
+        __m256i ordered = _mm256_permutevar8x32_epi32(keys, _mm256_and_si256(lanes, _mm256_set1_epi32(7)));
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(writeLeft), ordered);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(writeRight - 8), ordered);
+        return static_cast<int>(_mm_popcnt_u32(static_cast<unsigned int>(mask)));
+    }
+
+    // Split the first count keys with masked stores, which touch exactly the
+    // slots they fill; used once the free space is no longer a vector per side
+    TARGET_AVX2 inline void storeMaskedAvx2(__m256i keys, __m256i pivots, int count, int *&writeLeft, int *&writeRight)
+    {
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(pivots, keys))) & ((1 << count) - 1);
+        __m256i lanes = _mm256_srlv_epi32(_mm256_set1_epi32(static_cast<int>(permutations[mask])),
+                                          _mm256_setr_epi32(0, 4, 8, 12, 16, 20, 24, 28));
+        __m256i ordered = _mm256_permutevar8x32_epi32(keys, _mm256_and_si256(lanes, _mm256_set1_epi32(7)));
+        int smaller = static_cast<int>(_mm_popcnt_u32(static_cast<unsigned int>(mask)));
+
+        // The unused lanes sort last, so lanes [smaller, count) hold the others
+        __m256i index = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        __m256i left = _mm256_cmpgt_epi32(_mm256_set1_epi32(smaller), index);
+        __m256i right = _mm256_andnot_si256(left, _mm256_cmpgt_epi32(_mm256_set1_epi32(count), index));
+        _mm256_maskstore_epi32(writeLeft, left, ordered);
+        _mm256_maskstore_epi32(writeRight - count, right, ordered);
+        writeLeft += smaller;
+        writeRight -= count - smaller;
+    }
+
+    TARGET_AVX2 inline __m256i loadFirstAvx2(const int *keys, int count)
+    {
+        __m256i valid = _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        return _mm256_maskload_epi32(keys, valid);
+    }
+
+    // In-place vector partition after Bramas: one vector from each end is held
+    // in registers, which leaves a vector of free space on both sides. Each
+    // step reads the next vector from the side with less free space and writes
+    // its keys to both sides, so free space is never overrun.
+    TARGET_AVX2 int *partitionAvx2(int *first, int *last, int pivot)
+    {
+        const int width = 8;
+        __m256i pivots = _mm256_set1_epi32(pivot);
+        int *writeLeft = first;
+        int *writeRight = last;
+
+        // Small ranges fit in two registers
+        int size = static_cast<int>(last - first);
+        if (size < 2 * width)
+        {
+            int head = std::min(size, width);
+            __m256i low = loadFirstAvx2(first, head);
+            __m256i high = loadFirstAvx2(first + head, size - head);
+            storeMaskedAvx2(low, pivots, head, writeLeft, writeRight);
+            storeMaskedAvx2(high, pivots, size - head, writeLeft, writeRight);
+            return writeLeft;
+        }
+
+        __m256i savedLeft = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+        __m256i savedRight = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(last - width));
+        int *readLeft = first + width;
+        int *readRight = last - width;
+
+        while (readRight - readLeft >= width)
+        {
+            __m256i keys;
+            if (readLeft - writeLeft <= writeRight - readRight)
+            {
+                keys = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(readLeft));
+                readLeft += width;
+            }
+            else
+            {
+                readRight -= width;
+                keys = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(readRight));
+            }
+
+            int smaller = storeAvx2(keys, pivots, writeLeft, writeRight);
+            writeLeft += smaller;
+            writeRight -= width - smaller;
+        }
+
+        // Fewer than a vector of unread keys is left; once it is loaded, every
+        // slot between the write cursors is free for it and the held vectors
+        int restCount = static_cast<int>(readRight - readLeft);
+        __m256i rest = loadFirstAvx2(readLeft, restCount);
+        storeMaskedAvx2(rest, pivots, restCount, writeLeft, writeRight);
+        storeMaskedAvx2(savedLeft, pivots, width, writeLeft, writeRight);
+        storeMaskedAvx2(savedRight, pivots, width, writeLeft, writeRight);
+        return writeLeft;
+    }
+
+    // Split the keys of the lanes in valid with compressing stores
+    TARGET_AVX512 inline void storeMaskedAvx512(__m512i keys, __m512i pivots, __mmask16 valid, int *&writeLeft, int *&writeRight)
+    {
+        __mmask16 smaller = _mm512_mask_cmplt_epi32_mask(valid, keys, pivots);
+        __mmask16 others = static_cast<__mmask16>(valid & ~smaller);
+        writeRight -= _mm_popcnt_u32(others);
+        _mm512_mask_compressstoreu_epi32(writeLeft, smaller, keys);
+        _mm512_mask_compressstoreu_epi32(writeRight, others, keys);
+        writeLeft += _mm_popcnt_u32(smaller);
+    }
+
+    // The AVX2 scheme with sixteen keys and the native compress instructions
+    TARGET_AVX512 int *partitionAvx512(int *first, int *last, int pivot)
+    {
+        const int width = 16;
+        __m512i pivots = _mm512_set1_epi32(pivot);
+        int *writeLeft = first;
+        int *writeRight = last;
+
+        int size = static_cast<int>(last - first);
+        if (size < 2 * width)
+        {
+            int head = std::min(size, width);
+            __mmask16 lowLanes = static_cast<__mmask16>((1u << head) - 1);
+            __mmask16 highLanes = static_cast<__mmask16>((1u << (size - head)) - 1);
+            __m512i low = _mm512_maskz_loadu_epi32(lowLanes, first);
+            __m512i high = _mm512_maskz_loadu_epi32(highLanes, first + head);
+            storeMaskedAvx512(low, pivots, lowLanes, writeLeft, writeRight);
+            storeMaskedAvx512(high, pivots, highLanes, writeLeft, writeRight);
+            return writeLeft;
+        }
+
+        __m512i savedLeft = _mm512_loadu_si512(first);
+        __m512i savedRight = _mm512_loadu_si512(last - width);
+        int *readLeft = first + width;
+        int *readRight = last - width;
+
+        while (readRight - readLeft >= width)
+        {
+            __m512i keys;
+            if (readLeft - writeLeft <= writeRight - readRight)
+            {
+                keys = _mm512_loadu_si512(readLeft);
+                readLeft += width;
+            }
+            else
+            {
+                readRight -= width;
+                keys = _mm512_loadu_si512(readRight);
+            }
+
+            __mmask16 mask = _mm512_cmplt_epi32_mask(keys, pivots);
+            int smaller = static_cast<int>(_mm_popcnt_u32(mask));
+
+            // A full store on the left is cheaper than a compressing one
+            _mm512_storeu_si512(writeLeft, _mm512_maskz_compress_epi32(mask, keys));
+            _mm512_mask_compressstoreu_epi32(writeRight - (width - smaller), static_cast<__mmask16>(~mask), keys);
+            writeLeft += smaller;
+            writeRight -= width - smaller;
+        }
+
+        __mmask16 restLanes = static_cast<__mmask16>((1u << (readRight - readLeft)) - 1);
+        __m512i rest = _mm512_maskz_loadu_epi32(restLanes, readLeft);
+        storeMaskedAvx512(rest, pivots, restLanes, writeLeft, writeRight);
+        storeMaskedAvx512(savedLeft, pivots, 0xFFFF, writeLeft, writeRight);
+        storeMaskedAvx512(savedRight, pivots, 0xFFFF, writeLeft, writeRight);
+        return writeLeft;
+    }
+
+#if defined(_MSC_VER) && !defined(__clang__)
+    SimdLevel queryCpu()
+    {
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+        {
+            return SimdLevel::Scalar;
+        }
+
+        // The OS must save the wider registers on context switches
+        __cpuid(info, 1);
+        bool osSaves = (info[2] & (1 << 27)) != 0;
+        unsigned long long xcr0 = osSaves ? _xgetbv(0) : 0;
+        bool ymm = (xcr0 & 0x6) == 0x6;
+        bool zmm = (xcr0 & 0xE6) == 0xE6;
+        bool popcnt = (info[2] & (1 << 23)) != 0;
+
+        __cpuidex(info, 7, 0);
+        if (zmm && popcnt && (info[1] & (1 << 16)))
+        {
+            return SimdLevel::AVX512;
+        }
+        if (ymm && popcnt && (info[1] & (1 << 5)))
+        {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::Scalar;
+    }
+#else
+    SimdLevel queryCpu()
+    {
+        // Also checks that the OS enabled the registers
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("popcnt"))
+        {
+            return SimdLevel::AVX512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt"))
+        {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::Scalar;
+    }
+#endif
+#else
+    SimdLevel queryCpu()
+    {
+        return SimdLevel::Scalar;
+    }
+#endif
+}
+
+SimdLevel detectSimdLevel()
+{
+    static const SimdLevel level = queryCpu();
+    return level;
+}
+
+const char *getSimdLevelName(SimdLevel level)
+{
+    switch (level)
+    {
+    case SimdLevel::AVX2:
+        return "AVX2";
+    case SimdLevel::AVX512:
+        return "AVX-512";
+    default:
+        return "Scalar";
+    }
+}
+
+int *partitionLess(int *first, int *last, int pivot)
+{
+    return partitionLess(first, last, pivot, detectSimdLevel());
+}
+
+int *partitionLess(int *first, int *last, int pivot, SimdLevel level)
+{
+    if (static_cast<int>(level) > static_cast<int>(detectSimdLevel()))
+    {
+        level = detectSimdLevel();
+    }
+
+#ifdef SIMD_PARTITION_X86
+    switch (level)
+    {
+    case SimdLevel::AVX512:
+        return partitionAvx512(first, last, pivot);
+    case SimdLevel::AVX2:
+        return partitionAvx2(first, last, pivot);
+    default:
+        break;
+    }
+#endif
+    return partitionScalar(first, last, pivot);
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+// Vectorised partition kernel. The AVX2 and AVX-512 versions are compiled for
+// their instruction sets through function attributes and picked at run time,
+// so the engine still runs on any x86 (or non-x86) CPU via the scalar loop.
+
+enum class SimdLevel
+{
+    Scalar,
+    AVX2,  // 8 keys per instruction, compress through a permutation table
+    AVX512 // 16 keys per instruction, native compress
+};
+
+// Best level the running CPU and operating system support (checked once)
+SimdLevel detectSimdLevel();
+
+const char *getSimdLevelName(SimdLevel level);
+
+// Move the keys of [first, last) that are smaller than pivot to the front and
+// return the end of them; keys >= pivot follow. Not stable. Keys are moved
+// straight to their side, with no buffer beyond two vectors in registers.
+int *partitionLess(int *first, int *last, int pivot);
+
+// Same with an explicit level; levels above detectSimdLevel() run the best
+// supported one instead
+int *partitionLess(int *first, int *last, int pivot, SimdLevel level);
@@ -0,0 +1,204 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include "SimdPartition.h"
+#include <vector>
+#include <stack>
+#include <climits>
+
+// Quick Sort whose partition step compares 8 (AVX2) or 16 (AVX-512) keys per
+// instruction and writes both sides with a compress or a permutation-table
+// shuffle instead of swapping. The instruction set is picked at run time, with
+// a scalar branch-free fallback. Pivots are chosen as in Block Quick Sort, and
+// keys equal to the previous pivot are split off in one pass, so duplicates
+// and adversarial inputs stay O(n log n) (heapsort backs up the depth limit).
+//
+// Like Quick Sort, each update() partitions the range on top of sortStack_;
+// ranges up to sequentialThreshold keys are sorted in a single update().
+class SimdQuickSort final : public SteppedSortAlgorithm<SimdQuickSort>
+{
+public:
+    SimdQuickSort() : SteppedSortAlgorithm("SIMD Quick Sort") {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        sortStack_ = std::stack<Range>();
+
+        int n = static_cast<int>(array_->size());
+        if (n > 1)
+        {
+            sortStack_.push({0, n, 2 * floorLog2(n), true});
+        }
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning || sortStack_.empty())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+
+        // Get the next partition to process
+        Range range = sortStack_.top();
+        sortStack_.pop();
+
+        int *data = array_->data();
+        if (range.last - range.first <= sequentialThreshold || range.depthLimit == 0)
+        {
+            sortRange(data + range.first, data + range.last, range.leftmost, range.depthLimit);
+        }
+        else
+        {
+            int *first = data + range.first;
+            int *last = data + range.last;
+            int *pivot = partition(first, last, range.leftmost);
+
+            if (pivot == nullptr)
+            {
+                // Only keys greater than the previous pivot are left to sort
+                int equalEnd = static_cast<int>(splitEqual(first, last) - data);
+                pushRange({equalEnd, range.last, range.depthLimit, false});
+            }
+            else
+            {
+                // Push the larger side first so the smaller one is sorted next
+                int position = static_cast<int>(pivot - data);
+                Range left = {range.first, position, range.depthLimit - 1, range.leftmost};
+                Range right = {position + 1, range.last, range.depthLimit - 1, false};
+                if (left.last - left.first < right.last - right.first)
+                {
+                    std::swap(left, right);
+                }
+                pushRange(left);
+                pushRange(right);
+            }
+        }
+
+        if (sortStack_.empty())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+        return true;
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    struct Range
+    {
+        int first;
+        int last;
+        int depthLimit;
+        bool leftmost; // No smaller key precedes the range
+    };
+
+    static constexpr int sequentialThreshold = 4096;
+    static constexpr std::ptrdiff_t networkSortThreshold = 24;
+
+    // Choose a pivot and partition around it: keys smaller than the pivot end
+    // up left of the returned position, the others right of it. Returns
+    // nullptr instead if the pivot equals the key before the range.
+    int *partition(int *first, int *last, bool leftmost)
+    {
+        selectPivotToFront(first, last, metrics_);
+        int pivot = *first;
+
+        if (!leftmost)
+        {
+            metrics_.comparisons++;
+            if (!(*(first - 1) < pivot))
+            {
+                return nullptr;
+            }
+        }
+
+        int *smallerEnd = partitionLess(first + 1, last, pivot);
+        countPass(last - first - 1);
+
+        // Put the pivot between the two sides
+        int *pivotPosition = smallerEnd - 1;
+        *first = *pivotPosition;
+        *pivotPosition = pivot;
+        metrics_.writes += 2;
+        return pivotPosition;
+    }
+
+    // The pivot in *first equals the key before the range, so no key is
+    // smaller: gather the equal keys on the left and return their end
+    int *splitEqual(int *first, int *last)
+    {
+        int pivot = *first;
+        if (pivot == INT_MAX)
+        {
+            return last;
+        }
+        int *equalEnd = partitionLess(first + 1, last, pivot + 1);
+        countPass(last - first - 1);
+        return equalEnd;
+    }
+
+    // A partition pass compares and writes every key once
+    void countPass(std::ptrdiff_t size)
+    {
+        metrics_.comparisons += size;
+        metrics_.writes += size;
+    }
+
+    // Sort a range to completion: recurse into the smaller side, loop on the
+    // larger one
+    void sortRange(int *first, int *last, bool leftmost, int depthLimit)
+    {
+        while (last - first > networkSortThreshold)
+        {
+            if (depthLimit == 0)
+            {
+                heapSort(first, last, metrics_);
+                return;
+            }
+
+            int *pivot = partition(first, last, leftmost);
+            if (pivot == nullptr)
+            {
+                first = splitEqual(first, last);
+                continue;
+            }
+            --depthLimit;
+
+            if (pivot - first < last - pivot)
+            {
+                sortRange(first, pivot, leftmost, depthLimit);
+                first = pivot + 1;
+                leftmost = false;
+            }
+            else
+            {
+                sortRange(pivot + 1, last, false, depthLimit);
+                last = pivot;
+            }
+        }
+
+        networkSort(first, last, metrics_);
+    }
+
+    void pushRange(const Range &range)
+    {
+        if (range.last - range.first > 1)
+        {
+            sortStack_.push(range);
+        }
+    }
+
+    std::vector<int> *array_; // Pointer to the original array
+    std::stack<Range> sortStack_;
+};
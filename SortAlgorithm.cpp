@@ -2,9 +2,97 @@
 #include "BubbleSort.h"
 #include "QuickSort.h"
 #include "MergeSort.h"
+#include "IntroSort.h"
+#include "ThreeWayQuickSort.h"
+#include "BlockQuickSort.h"
+#include "PowerSort.h"
+#include "ParallelMergeSort.h"
+#include "ParallelQuickSort.h"
+#include "ParallelSampleSort.h"
+#include "RadixSort.h"
+#include "CountingSort.h"
+#include "ParallelRadixSort.h"
+#include "SimdQuickSort.h"
+#include "HeapSort.h"
+#include "OddEvenSort.h"
+#include "DualPivotQuickSort.h"
+#include "InPlaceMergeSort.h"
+#include "DistributionSort.h"
+#include "BinaryInsertionSort.h"
+#include "MergeInsertionSort.h"
+#include "CycleSort.h"
 #include <memory>
 #include <stdexcept>
 
+namespace
+{
+    struct SortVariant
+    {
+        std::string name;
+        std::unique_ptr<SortAlgorithm> (*create)();
+    };
+
+    // Every combination of the Quick Sort policies, generated at compile time
+    const std::vector<SortVariant> &getSortVariants()
+    {
+        static const std::vector<SortVariant> variants = []
+        {
+            std::vector<SortVariant> generated;
+            forEachQuickSortVariant([&](auto variant)
+                                    {
+                using Variant = typename decltype(variant)::type;
+                generated.push_back({Variant::getVariantName(), []() -> std::unique_ptr<SortAlgorithm>
+                                     { return std::make_unique<Variant>(); }}); });
+            return generated;
+        }();
+        return variants;
+    }
+}
+
+const std::vector<std::string> &getSortAlgorithmNames()
+{
+    static const std::vector<std::string> names = {
+        "Bubble Sort",
+        "Quick Sort",
+        "Dual-Pivot Quick Sort",
+        "Merge Sort",
+        "Intro Sort",
+        "3-Way Quick Sort",
+        "Block Quick Sort",
+        "Power Sort",
+        "Parallel Merge Sort",
+        "Parallel Quick Sort",
+        "Parallel Sample Sort",
+        "Radix Sort",
+        "Counting Sort",
+        "Parallel MSD Radix Sort",
+        "SIMD Quick Sort",
+        "Heap Sort",
+        "Odd-Even Sort",
+        "In-Place Merge Sort",
+        "Flashsort",
+        "Learned Sort",
+        "Binary Insertion Sort",
+        "Merge-Insertion Sort",
+        "Cycle Sort",
+    };
+    return names;
+}
+
+const std::vector<std::string> &getSortVariantNames()
+{
+    static const std::vector<std::string> names = []
+    {
+        std::vector<std::string> variantNames;
+        for (const auto &variant : getSortVariants())
+        {
+            variantNames.push_back(variant.name);
+        }
+        return variantNames;
+    }();
+    return names;
+}
+
 std::unique_ptr<SortAlgorithm> createSortAlgorithm(const std::string &algorithmName)
 {
     if (algorithmName == "Bubble Sort")
@@ -13,14 +101,99 @@ std::unique_ptr<SortAlgorithm> createSortAlgorithm(const std::string &algorithmN
     }
     else if (algorithmName == "Quick Sort")
     {
-        return std::make_unique<QuickSort>();
+        return std::make_unique<QuickSort>("Quick Sort");
     }
     else if (algorithmName == "Merge Sort")
     {
         return std::make_unique<MergeSort>();
     }
-    else
+    else if (algorithmName == "Intro Sort")
+    {
+        return std::make_unique<IntroSort>();
+    }
+    else if (algorithmName == "3-Way Quick Sort")
+    {
+        return std::make_unique<ThreeWayQuickSort>();
+    }
+    else if (algorithmName == "Block Quick Sort")
+    {
+        return std::make_unique<BlockQuickSort>();
+    }
+    else if (algorithmName == "Power Sort")
+    {
+        return std::make_unique<PowerSort>();
+    }
+    else if (algorithmName == "Parallel Merge Sort")
+    {
+        return std::make_unique<ParallelMergeSort>();
+    }
+    else if (algorithmName == "Parallel Quick Sort")
+    {
+        return std::make_unique<ParallelQuickSort>();
+    }
+    else if (algorithmName == "Parallel Sample Sort")
+    {
+        return std::make_unique<ParallelSampleSort>();
+    }
+    else if (algorithmName == "Radix Sort")
+    {
+        return std::make_unique<RadixSort>();
+    }
+    else if (algorithmName == "Counting Sort")
+    {
+        return std::make_unique<CountingSort>();
+    }
+    else if (algorithmName == "Parallel MSD Radix Sort")
+    {
+        return std::make_unique<ParallelRadixSort>();
+    }
+    else if (algorithmName == "SIMD Quick Sort")
+    {
+        return std::make_unique<SimdQuickSort>();
+    }
+    else if (algorithmName == "Heap Sort")
+    {
+        return std::make_unique<HeapSort>();
+    }
+    else if (algorithmName == "Odd-Even Sort")
+    {
+        return std::make_unique<OddEvenSort>();
+    }
+    else if (algorithmName == "Dual-Pivot Quick Sort")
+    {
+        return std::make_unique<DualPivotQuickSort>();
+    }
+    else if (algorithmName == "In-Place Merge Sort")
+    {
+        return std::make_unique<InPlaceMergeSort>();
+    }
+    else if (algorithmName == "Flashsort")
+    {
+        return std::make_unique<FlashSort>();
+    }
+    else if (algorithmName == "Learned Sort")
+    {
+        return std::make_unique<LearnedSort>();
+    }
+    else if (algorithmName == "Binary Insertion Sort")
+    {
+        return std::make_unique<BinaryInsertionSort>();
+    }
+    else if (algorithmName == "Merge-Insertion Sort")
+    {
+        return std::make_unique<MergeInsertionSort>();
+    }
+    else if (algorithmName == "Cycle Sort")
+    {
+        return std::make_unique<CycleSort>();
+    }
+
+    for (const auto &variant : getSortVariants())
     {
-        throw std::invalid_argument("Unknown sort algorithm: " + algorithmName);
+        if (variant.name == algorithmName)
+        {
+            return variant.create();
+        }
     }
+    throw std::invalid_argument("Unknown sort algorithm: " + algorithmName);
 }
\ No newline at end of file
@@ -4,17 +4,84 @@
 #include <string>
 #include <chrono>
 #include <memory>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+// Share of the work done by one thread of a parallel algorithm
+struct ThreadWork
+{
+    long long elements = 0; // Elements processed
+    double busyTime = 0.0;  // Seconds spent working
+};
+
+// Time spent in one named phase of a multi-phase algorithm
+struct PhaseTime
+{
+    std::string name;
+    double seconds = 0.0; // Summed over all threads
+};
+
+// Counters kept privately by one worker thread (padded to a cache line to
+// avoid false sharing) and folded into SortMetrics once the workers finish
+struct alignas(64) WorkerCounters
+{
+    long long comparisons = 0;
+    long long swaps = 0;
+    long long writes = 0;
+    long long elements = 0;
+    double busyTime = 0.0;
+};
+
+// Modeled cost of the operations counted in SortMetrics, for keys that are
+// far more expensive to compare than a native int or storage such as flash
+// where writes cost far more than reads. Reads are not counted separately:
+// each comparison is taken to load one key, the other being held in a
+// register (pivot, key being inserted or placed), and each write the key it
+// stores.
+struct CostModel
+{
+    double comparisonSeconds = 0.0; // Charged per comparison
+    double readSeconds = 0.0;       // Charged per key read
+    double writeSeconds = 0.0;      // Charged per key write
+
+    static long long reads(long long comparisons, long long writes)
+    {
+        return comparisons + writes;
+    }
+
+    double seconds(long long comparisons, long long writes) const
+    {
+        return comparisonSeconds * static_cast<double>(comparisons) +
+               readSeconds * static_cast<double>(reads(comparisons, writes)) +
+               writeSeconds * static_cast<double>(writes);
+    }
+
+    bool isFree() const { return comparisonSeconds <= 0.0 && readSeconds <= 0.0 && writeSeconds <= 0.0; }
+};
+
+// log2(n!), the fewest comparisons that can distinguish every order of n
+// distinct keys and so the floor no comparison sort can beat on average
+inline double comparisonLowerBound(long long n)
+{
+    return n > 1 ? std::lgamma(static_cast<double>(n) + 1.0) / std::log(2.0) : 0.0;
+}
 
 class SortMetrics
 {
 public:
-    SortMetrics() : comparisons(0), swaps(0), lastElapsed(0.0f) {}
+    SortMetrics() : comparisons(0), swaps(0), writes(0), lastElapsed(0.0f) {}
 
     void resetMetrics()
     {
         comparisons = 0;
         swaps = 0;
+        writes = 0;
+        auxMemoryBytes = 0;
         lastElapsed = 0.0f;
+        computeTime = 0.0;
+        threadWork.clear();
+        phaseTimes.clear();
         startTime = std::chrono::steady_clock::now();
     }
 
@@ -42,13 +109,64 @@ public:
         startTime = std::chrono::steady_clock::now();
     }
 
-    int comparisons;
-    int swaps;
+    // Fold per-worker counters into the totals and the per-thread breakdown
+    void addWorkerCounters(const std::vector<WorkerCounters> &workers)
+    {
+        if (threadWork.size() < workers.size())
+        {
+            threadWork.resize(workers.size());
+        }
+
+        for (size_t i = 0; i < workers.size(); ++i)
+        {
+            comparisons += workers[i].comparisons;
+            swaps += workers[i].swaps;
+            writes += workers[i].writes;
+            threadWork[i].elements += workers[i].elements;
+            threadWork[i].busyTime += workers[i].busyTime;
+        }
+    }
+
+    // Accumulate time spent in a named phase, keeping phases in first-seen order
+    void addPhaseTime(const std::string &name, double seconds)
+    {
+        for (auto &phase : phaseTimes)
+        {
+            if (phase.name == name)
+            {
+                phase.seconds += seconds;
+                return;
+            }
+        }
+        phaseTimes.push_back({name, seconds});
+    }
+
+    // Record a scratch allocation, keeping the peak
+    void noteAuxMemory(long long bytes)
+    {
+        auxMemoryBytes = std::max(auxMemoryBytes, bytes);
+    }
+
+    // Time spent inside the algorithm itself, excluding frame pacing
+    double getComputeTime() const { return computeTime; }
+    void addComputeTime(double seconds) { computeTime += seconds; }
+
+    // Compute time plus the modeled cost of the counted operations
+    double getModeledTime() const { return computeTime + costModel.seconds(comparisons, writes); }
+
+    long long comparisons;
+    long long swaps;
+    long long writes; // Element writes into the array or auxiliary buffers
+    long long auxMemoryBytes = 0; // Peak scratch memory beyond the array itself
+    std::vector<ThreadWork> threadWork; // Per-thread breakdown, filled by parallel algorithms
+    std::vector<PhaseTime> phaseTimes;  // Per-phase breakdown, filled by multi-phase algorithms
     bool isRunning = false;
+    CostModel costModel; // Configuration rather than a counter, so resetMetrics() keeps it
 
 private:
     std::chrono::steady_clock::time_point startTime;
     float lastElapsed;
+    double computeTime = 0.0;
 };
 
 class SortAlgorithm
@@ -57,12 +175,36 @@ public:
     SortAlgorithm(const std::string &name) : name_(name) {}
     virtual ~SortAlgorithm() = default;
 
+    // Hint the range [minVal, maxVal] the keys are drawn from, for algorithms
+    // that can exploit it; call before initialize(). Keys outside it must
+    // still be sorted correctly.
+    virtual void setValueRange(int /*minVal*/, int /*maxVal*/) {}
+
     // Initialize algorithm-specific state
     virtual void initialize(std::vector<int> &array) = 0;
 
     // Perform one iteration of the sort algorithm
     virtual bool update() = 0;
 
+    // Perform up to maxSteps iterations; returns false once the sort has finished
+    virtual bool runSteps(size_t maxSteps)
+    {
+        for (size_t i = 0; i < maxSteps; ++i)
+        {
+            if (!update())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Run the algorithm until the array is sorted
+    void runToCompletion()
+    {
+        runSteps(std::numeric_limits<size_t>::max());
+    }
+
     // Get the current array state
     virtual const std::vector<int> &getCurrentArray() const = 0;
 
@@ -91,5 +233,35 @@ protected:
     SortMetrics metrics_;
 };
 
+// Base for concrete algorithms: runSteps() calls Derived::update() statically,
+// so a whole batch of steps costs a single virtual call
+template <typename Derived>
+class SteppedSortAlgorithm : public SortAlgorithm
+{
+public:
+    using SortAlgorithm::SortAlgorithm;
+
+    bool runSteps(size_t maxSteps) override
+    {
+        Derived &self = static_cast<Derived &>(*this);
+        for (size_t i = 0; i < maxSteps; ++i)
+        {
+            if (!self.Derived::update())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Names of all algorithms known to createSortAlgorithm(), in display order
+const std::vector<std::string> &getSortAlgorithmNames();
+
+// Names of the generated variants (every Quick Sort policy combination). They
+// are known to createSortAlgorithm() too, but left out of the list above so
+// the default benchmark run stays short.
+const std::vector<std::string> &getSortVariantNames();
+
 // Factory method to create sort algorithms
 std::unique_ptr<SortAlgorithm> createSortAlgorithm(const std::string &algorithmName);
\ No newline at end of file
@@ -5,6 +5,17 @@
 #include <random>
 #include <algorithm>
 
+// Shape of the generated input data
+enum class ArrayDistribution
+{
+    Random,       // Uniform values in [minVal, maxVal]
+    Sorted,       // Ascending
+    Reversed,     // Descending
+    NearlySorted, // Ascending with ~1% of elements swapped at random
+    FewUnique,    // Only 16 distinct values
+    Skewed        // Bunched towards minVal: the cube of a uniform variate, scaled
+};
+
 class SortArray
 {
 public:
@@ -30,6 +41,91 @@ public:
         }
     }
 
+    // Generate a new array with the given shape; a fixed seed gives reproducible data
+    void generateArray(ArrayDistribution distribution, unsigned int seed)
+    {
+        std::mt19937 gen(seed);
+        std::uniform_int_distribution<> distr(minVal_, maxVal_);
+
+        array_.clear();
+        array_.reserve(size_);
+
+        if (distribution == ArrayDistribution::FewUnique)
+        {
+            std::vector<int> values(16);
+            for (auto &value : values)
+            {
+                value = distr(gen);
+            }
+
+            std::uniform_int_distribution<> pick(0, static_cast<int>(values.size()) - 1);
+            for (int i = 0; i < size_; ++i)
+            {
+                array_.push_back(values[pick(gen)]);
+            }
+            return;
+        }
+
+        if (distribution == ArrayDistribution::Skewed)
+        {
+            // Half the keys fall in the lowest eighth of the range
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+            double range = static_cast<double>(maxVal_) - minVal_;
+            for (int i = 0; i < size_; ++i)
+            {
+                double u = unit(gen);
+                array_.push_back(minVal_ + static_cast<int>(range * u * u * u));
+            }
+            return;
+        }
+
+        for (int i = 0; i < size_; ++i)
+        {
+            array_.push_back(distr(gen));
+        }
+
+        if (distribution == ArrayDistribution::Random)
+        {
+            return;
+        }
+
+        std::sort(array_.begin(), array_.end());
+
+        if (distribution == ArrayDistribution::Reversed)
+        {
+            std::reverse(array_.begin(), array_.end());
+        }
+        else if (distribution == ArrayDistribution::NearlySorted && size_ > 1)
+        {
+            std::uniform_int_distribution<> index(0, size_ - 1);
+            for (int i = 0; i < size_ / 100; ++i)
+            {
+                std::swap(array_[index(gen)], array_[index(gen)]);
+            }
+        }
+    }
+
+    // Display name of a distribution
+    static const char *getDistributionName(ArrayDistribution distribution)
+    {
+        switch (distribution)
+        {
+        case ArrayDistribution::Random:
+            return "random";
+        case ArrayDistribution::Sorted:
+            return "sorted";
+        case ArrayDistribution::Reversed:
+            return "reversed";
+        case ArrayDistribution::NearlySorted:
+            return "nearly-sorted";
+        case ArrayDistribution::FewUnique:
+            return "few-unique";
+        case ArrayDistribution::Skewed:
+            return "skewed";
+        }
+        return "unknown";
+    }
+
     // Get array as string for display
     std::string toString() const
     {
@@ -0,0 +1,551 @@
+#include "SortAlgorithm.h"
+#include "SortArray.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    struct BenchmarkConfig
+    {
+        std::vector<std::string> algorithms = getSortAlgorithmNames();
+        std::vector<int> sizes = {100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+        std::vector<ArrayDistribution> distributions = {
+            ArrayDistribution::Random,
+            ArrayDistribution::Sorted,
+            ArrayDistribution::Reversed,
+            ArrayDistribution::NearlySorted,
+            ArrayDistribution::FewUnique,
+            ArrayDistribution::Skewed,
+        };
+        int warmup = 1;
+        int repetitions = 5;
+        double timeLimit = 10.0; // Seconds allowed for a single sort before giving up
+        unsigned int seed = 42;
+        CostModel costModel; // Modeled operation costs added to the measured time
+        int threads = 0; // Shared pool size for parallel algorithms, 0 = one per hardware thread
+        std::string format = "table";
+        std::string outputPath;
+    };
+
+    enum class RunStatus
+    {
+        Ok,
+        Timeout,
+        Unsorted,
+        Corrupted, // Sorted, but not a permutation of the input
+        Skipped
+    };
+
+    struct BenchmarkResult
+    {
+        std::string algorithm;
+        std::string distribution;
+        int size = 0;
+        RunStatus status = RunStatus::Ok;
+        int repetitions = 0;
+        double medianNsPerElement = 0.0;
+        double madNsPerElement = 0.0;
+        double modeledNsPerElement = 0.0; // Median plus the modeled cost of the counted operations
+        long long comparisons = 0;
+        long long swaps = 0;
+        long long writes = 0;
+        long long auxMemoryBytes = 0;
+        std::vector<ThreadWork> threadWork;
+        std::vector<PhaseTime> phaseTimes;
+    };
+
+    const char *statusName(RunStatus status)
+    {
+        switch (status)
+        {
+        case RunStatus::Ok:
+            return "ok";
+        case RunStatus::Timeout:
+            return "timeout";
+        case RunStatus::Unsorted:
+            return "unsorted";
+        case RunStatus::Corrupted:
+            return "corrupted";
+        case RunStatus::Skipped:
+            return "skipped";
+        }
+        return "unknown";
+    }
+
+    double median(std::vector<double> values)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+
+        std::sort(values.begin(), values.end());
+        size_t mid = values.size() / 2;
+        return (values.size() % 2) ? values[mid] : 0.5 * (values[mid - 1] + values[mid]);
+    }
+
+    // Median absolute deviation around the median
+    double medianAbsoluteDeviation(const std::vector<double> &values, double center)
+    {
+        std::vector<double> deviations;
+        deviations.reserve(values.size());
+        for (double value : values)
+        {
+            deviations.push_back(std::fabs(value - center));
+        }
+        return median(deviations);
+    }
+
+    // Sort one copy of the input, giving up once the time limit is exceeded,
+    // and check the result against the expected output
+    RunStatus runOnce(SortAlgorithm &algorithm, const std::vector<int> &input, const std::vector<int> &expected,
+                      std::vector<int> &work, double timeLimit, double &seconds)
+    {
+        work.assign(input.begin(), input.end());
+
+        auto start = Clock::now();
+        algorithm.initialize(work);
+
+        // Run in batches so the clock is only checked every millisecond or so;
+        // the batch grows while steps are cheap
+        size_t batch = 1;
+        auto batchStart = start;
+        while (algorithm.runSteps(batch))
+        {
+            auto now = Clock::now();
+            if (std::chrono::duration<double>(now - start).count() > timeLimit)
+            {
+                algorithm.stop();
+                return RunStatus::Timeout;
+            }
+
+            if (now - batchStart < std::chrono::milliseconds(1) && batch < (size_t(1) << 20))
+            {
+                batch *= 2;
+            }
+            batchStart = now;
+        }
+
+        seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        algorithm.stop();
+
+        if (work == expected)
+        {
+            return RunStatus::Ok;
+        }
+
+        // Keys dropped, duplicated or overwritten can still leave the array sorted
+        return std::is_sorted(work.begin(), work.end()) ? RunStatus::Corrupted : RunStatus::Unsorted;
+    }
+
+    BenchmarkResult runBenchmark(const BenchmarkConfig &config, const std::string &algorithmName,
+                                 ArrayDistribution distribution, int size)
+    {
+        BenchmarkResult result;
+        result.algorithm = algorithmName;
+        result.distribution = SortArray::getDistributionName(distribution);
+        result.size = size;
+
+        SortArray array(0);
+        array.setSize(size);
+        array.generateArray(distribution, config.seed);
+        std::vector<int> input = std::move(array.getArray());
+        std::vector<int> expected = input;
+        std::sort(expected.begin(), expected.end());
+        std::vector<int> work(input.size());
+
+        auto algorithm = createSortAlgorithm(algorithmName);
+        algorithm->setValueRange(array.getMinVal(), array.getMaxVal());
+        algorithm->getMetrics().costModel = config.costModel;
+        std::vector<double> samples;
+
+        for (int rep = 0; rep < config.warmup + config.repetitions; ++rep)
+        {
+            double seconds = 0.0;
+            result.status = runOnce(*algorithm, input, expected, work, config.timeLimit, seconds);
+            if (result.status != RunStatus::Ok)
+            {
+                break;
+            }
+
+            if (rep >= config.warmup)
+            {
+                samples.push_back(seconds * 1e9 / std::max(1, size));
+            }
+        }
+
+        const SortMetrics &metrics = algorithm->getMetrics();
+        result.comparisons = metrics.comparisons;
+        result.swaps = metrics.swaps;
+        result.writes = metrics.writes;
+        result.auxMemoryBytes = metrics.auxMemoryBytes;
+        result.threadWork = metrics.threadWork;
+        result.phaseTimes = metrics.phaseTimes;
+        result.repetitions = static_cast<int>(samples.size());
+        result.medianNsPerElement = median(samples);
+        result.madNsPerElement = medianAbsoluteDeviation(samples, result.medianNsPerElement);
+        result.modeledNsPerElement =
+            result.medianNsPerElement + metrics.costModel.seconds(metrics.comparisons, metrics.writes) * 1e9 / std::max(1, size);
+        return result;
+    }
+
+    std::string jsonEscape(const std::string &text)
+    {
+        std::string escaped;
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                escaped += '\\';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    void writeTable(std::ostream &out, const std::vector<BenchmarkResult> &results)
+    {
+        // Widen the first column for long names such as the Quick Sort variants
+        int nameWidth = 24;
+        for (const auto &r : results)
+        {
+            nameWidth = std::max(nameWidth, static_cast<int>(r.algorithm.size()));
+        }
+
+        char line[256];
+        std::snprintf(line, sizeof(line), "%-*s %-14s %10s %12s %10s %12s %16s %16s %16s %12s  %s\n",
+                      nameWidth, "algorithm", "distribution", "size", "ns/elem", "mad", "modeled", "comparisons",
+                      "swaps", "bytes moved", "aux bytes", "status");
+        out << line;
+
+        for (const auto &r : results)
+        {
+            std::snprintf(line, sizeof(line), "%-*s %-14s %10d %12.3f %10.3f %12.3f %16lld %16lld %16lld %12lld  %s\n",
+                          nameWidth, r.algorithm.c_str(), r.distribution.c_str(), r.size, r.medianNsPerElement,
+                          r.madNsPerElement, r.modeledNsPerElement, r.comparisons, r.swaps,
+                          r.writes * static_cast<long long>(sizeof(int)), r.auxMemoryBytes, statusName(r.status));
+            out << line;
+        }
+    }
+
+    void writeCsv(std::ostream &out, const std::vector<BenchmarkResult> &results)
+    {
+        out << "algorithm,distribution,size,status,repetitions,median_ns_per_element,"
+               "mad_ns_per_element,modeled_ns_per_element,comparisons,swaps,bytes_moved,aux_bytes\n";
+
+        for (const auto &r : results)
+        {
+            out << '"' << r.algorithm << "\"," << r.distribution << ',' << r.size << ','
+                << statusName(r.status) << ',' << r.repetitions << ',' << r.medianNsPerElement << ','
+                << r.madNsPerElement << ',' << r.modeledNsPerElement << ',' << r.comparisons << ','
+                << r.swaps << ','
+                << r.writes * static_cast<long long>(sizeof(int)) << ',' << r.auxMemoryBytes << '\n';
+        }
+    }
+
+    void writeJson(std::ostream &out, const BenchmarkConfig &config, const std::vector<BenchmarkResult> &results)
+    {
+        out << "{\n  \"threads\": " << ThreadPool::getShared().getThreadCount()
+            << ",\n  \"warmup\": " << config.warmup << ",\n  \"repetitions\": " << config.repetitions
+            << ",\n  \"seed\": " << config.seed
+            << ",\n  \"comparison_cost_ns\": " << config.costModel.comparisonSeconds * 1e9
+            << ",\n  \"read_cost_ns\": " << config.costModel.readSeconds * 1e9
+            << ",\n  \"write_cost_ns\": " << config.costModel.writeSeconds * 1e9 << ",\n  \"results\": [\n";
+
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+            const auto &r = results[i];
+            out << "    {\"algorithm\": \"" << jsonEscape(r.algorithm) << "\", \"distribution\": \""
+                << r.distribution << "\", \"size\": " << r.size << ", \"status\": \"" << statusName(r.status)
+                << "\", \"repetitions\": " << r.repetitions
+                << ", \"median_ns_per_element\": " << r.medianNsPerElement
+                << ", \"mad_ns_per_element\": " << r.madNsPerElement
+                << ", \"modeled_ns_per_element\": " << r.modeledNsPerElement
+                << ", \"comparisons\": " << r.comparisons << ", \"swaps\": " << r.swaps
+                << ", \"bytes_moved\": " << r.writes * static_cast<long long>(sizeof(int))
+                << ", \"aux_bytes\": " << r.auxMemoryBytes;
+
+            if (!r.threadWork.empty())
+            {
+                out << ", \"threads\": [";
+                for (size_t t = 0; t < r.threadWork.size(); ++t)
+                {
+                    out << (t ? ", " : "") << "{\"elements\": " << r.threadWork[t].elements
+                        << ", \"busy_seconds\": " << r.threadWork[t].busyTime << "}";
+                }
+                out << "]";
+            }
+
+            if (!r.phaseTimes.empty())
+            {
+                out << ", \"phases\": {";
+                for (size_t p = 0; p < r.phaseTimes.size(); ++p)
+                {
+                    out << (p ? ", " : "") << '"' << jsonEscape(r.phaseTimes[p].name)
+                        << "\": " << r.phaseTimes[p].seconds;
+                }
+                out << "}";
+            }
+
+            out << "}"
+                << (i + 1 < results.size() ? "," : "") << "\n";
+        }
+
+        out << "  ]\n}\n";
+    }
+
+    std::vector<std::string> splitList(const std::string &text)
+    {
+        std::vector<std::string> items;
+        std::stringstream stream(text);
+        std::string item;
+        while (std::getline(stream, item, ','))
+        {
+            if (!item.empty())
+            {
+                items.push_back(item);
+            }
+        }
+        return items;
+    }
+
+    ArrayDistribution parseDistribution(const std::string &name)
+    {
+        for (auto distribution : {ArrayDistribution::Random, ArrayDistribution::Sorted,
+                                  ArrayDistribution::Reversed, ArrayDistribution::NearlySorted,
+                                  ArrayDistribution::FewUnique, ArrayDistribution::Skewed})
+        {
+            if (name == SortArray::getDistributionName(distribution))
+            {
+                return distribution;
+            }
+        }
+        throw std::invalid_argument("Unknown distribution: " + name);
+    }
+
+    void printUsage()
+    {
+        std::cout
+            << "Usage: SortBenchmark [options]\n"
+               "  --algorithms LIST      Comma-separated algorithm names (default: all)\n"
+               "  --sizes LIST           Comma-separated sizes, e.g. 1e3,1e6 (default: 1e2..1e8)\n"
+               "  --distributions LIST   random,sorted,reversed,nearly-sorted,few-unique,skewed\n"
+               "                         (default: all)\n"
+               "  --warmup N             Untimed runs before measuring (default: 1)\n"
+               "  --reps N               Timed repetitions (default: 5)\n"
+               "  --time-limit SEC       Give up on a single sort after SEC seconds (default: 10)\n"
+               "  --seed N               Input generator seed (default: 42)\n"
+               "  --threads N            Threads for parallel algorithms (default: all hardware threads)\n"
+               "  --comparison-cost NS   Modeled cost of each comparison (default: 0)\n"
+               "  --read-cost NS         Modeled cost of each key read (default: 0)\n"
+               "  --write-cost NS        Modeled cost of each key write (default: 0)\n"
+               "  --format FMT           table, csv or json (default: table)\n"
+               "  --output FILE          Write results to FILE instead of stdout\n"
+               "  --variants             Benchmark the generated Quick Sort variants instead\n"
+               "  --list                 List available algorithms and variants\n";
+    }
+
+    BenchmarkConfig parseArguments(int argc, char **argv)
+    {
+        BenchmarkConfig config;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto value = [&]() -> std::string
+            {
+                if (i + 1 >= argc)
+                {
+                    throw std::invalid_argument("Missing value for " + arg);
+                }
+                return argv[++i];
+            };
+
+            if (arg == "--algorithms")
+            {
+                config.algorithms = splitList(value());
+            }
+            else if (arg == "--sizes")
+            {
+                config.sizes.clear();
+                for (const auto &size : splitList(value()))
+                {
+                    config.sizes.push_back(static_cast<int>(std::stod(size)));
+                }
+            }
+            else if (arg == "--distributions")
+            {
+                config.distributions.clear();
+                for (const auto &name : splitList(value()))
+                {
+                    config.distributions.push_back(parseDistribution(name));
+                }
+            }
+            else if (arg == "--warmup")
+            {
+                config.warmup = std::stoi(value());
+            }
+            else if (arg == "--reps")
+            {
+                config.repetitions = std::max(1, std::stoi(value()));
+            }
+            else if (arg == "--time-limit")
+            {
+                config.timeLimit = std::stod(value());
+            }
+            else if (arg == "--threads")
+            {
+                config.threads = std::stoi(value());
+            }
+            else if (arg == "--comparison-cost")
+            {
+                config.costModel.comparisonSeconds = std::max(0.0, std::stod(value())) * 1e-9;
+            }
+            else if (arg == "--read-cost")
+            {
+                config.costModel.readSeconds = std::max(0.0, std::stod(value())) * 1e-9;
+            }
+            else if (arg == "--write-cost")
+            {
+                config.costModel.writeSeconds = std::max(0.0, std::stod(value())) * 1e-9;
+            }
+            else if (arg == "--seed")
+            {
+                config.seed = static_cast<unsigned int>(std::stoul(value()));
+            }
+            else if (arg == "--format")
+            {
+                config.format = value();
+                if (config.format != "table" && config.format != "csv" && config.format != "json")
+                {
+                    throw std::invalid_argument("Unknown format: " + config.format);
+                }
+            }
+            else if (arg == "--output")
+            {
+                config.outputPath = value();
+            }
+            else if (arg == "--variants")
+            {
+                config.algorithms = getSortVariantNames();
+            }
+            else if (arg == "--list")
+            {
+                for (const auto &name : getSortAlgorithmNames())
+                {
+                    std::cout << name << "\n";
+                }
+                for (const auto &name : getSortVariantNames())
+                {
+                    std::cout << name << "\n";
+                }
+                std::exit(0);
+            }
+            else if (arg == "--help" || arg == "-h")
+            {
+                printUsage();
+                std::exit(0);
+            }
+            else
+            {
+                throw std::invalid_argument("Unknown option: " + arg);
+            }
+        }
+
+        std::sort(config.sizes.begin(), config.sizes.end());
+        return config;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    BenchmarkConfig config;
+    try
+    {
+        config = parseArguments(argc, argv);
+        ThreadPool::configureShared(config.threads);
+        for (const auto &name : config.algorithms)
+        {
+            createSortAlgorithm(name); // Validate names before spending time on runs
+        }
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << e.what() << "\n";
+        printUsage();
+        return 1;
+    }
+
+    std::vector<BenchmarkResult> results;
+    bool failed = false;
+
+    for (const auto &algorithmName : config.algorithms)
+    {
+        for (auto distribution : config.distributions)
+        {
+            bool gaveUp = false;
+            for (int size : config.sizes)
+            {
+                if (gaveUp)
+                {
+                    // A smaller size already exceeded the time limit; larger ones will too
+                    BenchmarkResult skipped;
+                    skipped.algorithm = algorithmName;
+                    skipped.distribution = SortArray::getDistributionName(distribution);
+                    skipped.size = size;
+                    skipped.status = RunStatus::Skipped;
+                    results.push_back(skipped);
+                    continue;
+                }
+
+                std::cerr << algorithmName << " / " << SortArray::getDistributionName(distribution)
+                          << " / " << size << "\n";
+
+                results.push_back(runBenchmark(config, algorithmName, distribution, size));
+                gaveUp = results.back().status == RunStatus::Timeout;
+                failed = failed || results.back().status == RunStatus::Unsorted ||
+                         results.back().status == RunStatus::Corrupted;
+            }
+        }
+    }
+
+    std::ofstream file;
+    if (!config.outputPath.empty())
+    {
+        file.open(config.outputPath);
+        if (!file)
+        {
+            std::cerr << "Cannot open " << config.outputPath << "\n";
+            return 1;
+        }
+    }
+    std::ostream &out = config.outputPath.empty() ? std::cout : file;
+
+    if (config.format == "json")
+    {
+        writeJson(out, config, results);
+    }
+    else if (config.format == "csv")
+    {
+        writeCsv(out, results);
+    }
+    else
+    {
+        writeTable(out, results);
+    }
+
+    return failed ? 2 : 0;
+}
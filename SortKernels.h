@@ -0,0 +1,633 @@
+#pragma once
+
+#include "SortingNetworks.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+// Building blocks shared by the sorting algorithms. Every kernel works on a raw
+// [first, last) range and reports its work through a counters object with
+// comparisons, swaps and writes members (SortMetrics, or a thread-local tally).
+
+// Insertion sort, the base case for small partitions
+template <typename Counters>
+inline void insertionSort(int *first, int *last, Counters &counters)
+{
+    if (last - first < 2)
+    {
+        return;
+    }
+
+    for (int *i = first + 1; i < last; ++i)
+    {
+        int value = *i;
+        int *j = i;
+
+        while (j > first)
+        {
+            counters.comparisons++;
+            if (!(value < *(j - 1)))
+            {
+                break;
+            }
+            *j = *(j - 1);
+            --j;
+        }
+
+        if (j != i)
+        {
+            *j = value;
+            counters.writes += (i - j) + 1;
+            counters.swaps++;
+        }
+    }
+}
+
+// Binary insertion sort of [first, last) where [first, sortedEnd) is already
+// sorted. Stable, and uses only O(log n) comparisons per inserted element.
+template <typename Counters>
+inline void binaryInsertionSort(int *first, int *sortedEnd, int *last, Counters &counters)
+{
+    for (int *i = sortedEnd; i < last; ++i)
+    {
+        int value = *i;
+        int *position = std::upper_bound(first, i, value, [&counters](int a, int b)
+                                         {
+                                             counters.comparisons++;
+                                             return a < b; });
+
+        if (position != i)
+        {
+            std::copy_backward(position, i, i + 1);
+            *position = value;
+            counters.writes += (i - position) + 1;
+            counters.swaps++;
+        }
+    }
+}
+
+// Order three elements in place so that *a <= *b <= *c
+template <typename Counters>
+inline void sortThree(int *a, int *b, int *c, Counters &counters)
+{
+    counters.comparisons += 3;
+    if (*b < *a)
+    {
+        std::swap(*a, *b);
+        counters.swaps++;
+        counters.writes += 2;
+    }
+    if (*c < *b)
+    {
+        std::swap(*b, *c);
+        counters.swaps++;
+        counters.writes += 2;
+    }
+    if (*b < *a)
+    {
+        std::swap(*a, *b);
+        counters.swaps++;
+        counters.writes += 2;
+    }
+}
+
+// Move a robust pivot to *first: median of three for small ranges, Tukey's
+// ninther (median of three medians) for large ones. Afterwards a key after
+// *first is no smaller than the pivot: the median of three leaves the largest
+// of its keys at last - 1, the ninther the largest of the three medians at
+// mid + 1. That key stops the unguarded scan of partitionBlock().
+template <typename Counters>
+inline void selectPivotToFront(int *first, int *last, Counters &counters)
+{
+    const std::ptrdiff_t nintherThreshold = 128;
+    std::ptrdiff_t size = last - first;
+    int *mid = first + size / 2;
+
+    if (size > nintherThreshold)
+    {
+        sortThree(first, mid, last - 1, counters);
+        sortThree(first + 1, mid - 1, last - 2, counters);
+        sortThree(first + 2, mid + 1, last - 3, counters);
+        sortThree(mid - 1, mid, mid + 1, counters);
+        std::swap(*first, *mid);
+        counters.swaps++;
+        counters.writes += 2;
+    }
+    else
+    {
+        sortThree(mid, first, last - 1, counters);
+    }
+}
+
+// Partition around the pivot stored in *first (Sedgewick's Hoare variant).
+// Both scans stop on keys equal to the pivot, so duplicates split evenly.
+// Returns the final pivot position.
+template <typename Counters>
+inline int *partitionAroundFront(int *first, int *last, Counters &counters)
+{
+    int pivot = *first;
+    int *i = first;
+    int *j = last;
+
+    while (true)
+    {
+        while (++i < last - 1)
+        {
+            counters.comparisons++;
+            if (!(*i < pivot))
+            {
+                break;
+            }
+        }
+
+        while (pivot < *--j)
+        {
+            counters.comparisons++;
+        }
+        counters.comparisons++;
+
+        if (i >= j)
+        {
+            break;
+        }
+
+        std::swap(*i, *j);
+        counters.swaps++;
+        counters.writes += 2;
+    }
+
+    std::swap(*first, *j);
+    counters.swaps++;
+    counters.writes += 2;
+    return j;
+}
+
+// Block partition after Edelkamp and Weiss (BlockQuicksort), in the layout
+// popularised by pdqsort. Comparisons only record the offsets of misplaced
+// elements into two small buffers (no data-dependent branch), and the swaps
+// are done afterwards in a separate loop. Expects the pivot in *first as left
+// by selectPivotToFront(). Keys smaller than the pivot end up left of the
+// returned pivot position, keys greater or equal to its right.
+template <typename Counters>
+inline int *partitionBlock(int *first, int *last, Counters &counters)
+{
+    const std::ptrdiff_t blockSize = 64;
+
+    int pivot = *first;
+    int *l = first;
+    int *r = last;
+
+    // Find the first key >= pivot; selectPivotToFront() leaves one to stop at
+    while (*++l < pivot)
+    {
+        counters.comparisons++;
+    }
+    counters.comparisons++;
+
+    // Find the last key < pivot, guarded if nothing smaller was seen on the left
+    if (l - 1 == first)
+    {
+        while (l < r)
+        {
+            counters.comparisons++;
+            if (*--r < pivot)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        while (!(*--r < pivot))
+        {
+            counters.comparisons++;
+        }
+        counters.comparisons++;
+    }
+
+    if (l < r)
+    {
+        std::swap(*l, *r);
+        ++l;
+        counters.swaps++;
+        counters.writes += 2;
+
+        unsigned char offsetsL[blockSize];
+        unsigned char offsetsR[blockSize];
+        int *baseL = l;
+        int *baseR = r;
+        std::ptrdiff_t numL = 0, numR = 0, startL = 0, startR = 0;
+
+        while (l < r)
+        {
+            // Refill whichever offset buffer is empty from the unknown middle
+            std::ptrdiff_t unknown = r - l;
+            std::ptrdiff_t leftSplit = numL == 0 ? (numR == 0 ? unknown / 2 : unknown) : 0;
+            std::ptrdiff_t rightSplit = numR == 0 ? unknown - leftSplit : 0;
+            leftSplit = std::min(leftSplit, blockSize);
+            rightSplit = std::min(rightSplit, blockSize);
+
+            for (std::ptrdiff_t i = 0; i < leftSplit; ++i)
+            {
+                offsetsL[numL] = static_cast<unsigned char>(i);
+                numL += !(*l < pivot);
+                ++l;
+            }
+
+            for (std::ptrdiff_t i = 0; i < rightSplit; ++i)
+            {
+                offsetsR[numR] = static_cast<unsigned char>(i + 1);
+                numR += *--r < pivot;
+            }
+            counters.comparisons += leftSplit + rightSplit;
+
+            // Swap misplaced pairs
+            std::ptrdiff_t num = std::min(numL, numR);
+            for (std::ptrdiff_t i = 0; i < num; ++i)
+            {
+                std::swap(baseL[offsetsL[startL + i]], *(baseR - offsetsR[startR + i]));
+            }
+            counters.swaps += num;
+            counters.writes += 2 * num;
+
+            numL -= num;
+            numR -= num;
+            startL += num;
+            startR += num;
+
+            if (numL == 0)
+            {
+                startL = 0;
+                baseL = l;
+            }
+            if (numR == 0)
+            {
+                startR = 0;
+                baseR = r;
+            }
+        }
+
+        // One buffer may still hold misplaced keys; move them across the boundary
+        if (numL)
+        {
+            counters.swaps += numL;
+            counters.writes += 2 * numL;
+            while (numL--)
+            {
+                std::swap(baseL[offsetsL[startL + numL]], *--r);
+            }
+            l = r;
+        }
+        if (numR)
+        {
+            counters.swaps += numR;
+            counters.writes += 2 * numR;
+            while (numR--)
+            {
+                std::swap(*(baseR - offsetsR[startR + numR]), *l);
+                ++l;
+            }
+        }
+    }
+
+    // Put the pivot between the two sides
+    int *pivotPosition = l - 1;
+    *first = *pivotPosition;
+    *pivotPosition = pivot;
+    counters.writes += 2;
+    return pivotPosition;
+}
+
+// Partition for a pivot equal to the key just before the range (which bounds
+// the range from below): gathers every key equal to the pivot on the left and
+// returns the last of them, so only the right side needs further sorting.
+template <typename Counters>
+inline int *partitionEqualLeft(int *first, int *last, Counters &counters)
+{
+    int pivot = *first;
+    int *l = first;
+    int *r = last;
+
+    while (pivot < *--r)
+    {
+        counters.comparisons++;
+    }
+    counters.comparisons++;
+
+    if (r + 1 == last)
+    {
+        while (l < r)
+        {
+            counters.comparisons++;
+            if (pivot < *++l)
+            {
+                break;
+            }
+        }
+    }
+    else
+    {
+        while (!(pivot < *++l))
+        {
+            counters.comparisons++;
+        }
+        counters.comparisons++;
+    }
+
+    while (l < r)
+    {
+        std::swap(*l, *r);
+        counters.swaps++;
+        counters.writes += 2;
+
+        while (pivot < *--r)
+        {
+            counters.comparisons++;
+        }
+        while (!(pivot < *++l))
+        {
+            counters.comparisons++;
+        }
+        counters.comparisons += 2;
+    }
+
+    *first = *r;
+    *r = pivot;
+    counters.writes += 2;
+    return r;
+}
+
+// Dutch national flag partition around the pivot stored in *first. Returns
+// {lt, gt} such that [first, lt) < pivot, [lt, gt) == pivot, [gt, last) > pivot;
+// the equal block never needs to be touched again.
+template <typename Counters>
+inline std::pair<int *, int *> partitionThreeWay(int *first, int *last, Counters &counters)
+{
+    int pivot = *first;
+    int *lt = first;
+    int *i = first + 1;
+    int *gt = last;
+
+    while (i < gt)
+    {
+        counters.comparisons++;
+        if (*i < pivot)
+        {
+            std::swap(*lt++, *i++);
+            counters.swaps++;
+            counters.writes += 2;
+            continue;
+        }
+
+        counters.comparisons++;
+        if (pivot < *i)
+        {
+            std::swap(*i, *--gt);
+            counters.swaps++;
+            counters.writes += 2;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+
+    return {lt, gt};
+}
+
+// Heaps are 4-ary: the children of node i are i * 4 + 1 to i * 4 + 4, four
+// keys in 16 bytes. With the heap placed so that these groups are 16-byte
+// aligned, each level of a sift-down reads a single cache line, and there are
+// half as many levels as in a binary heap.
+constexpr std::ptrdiff_t heapArity = 4; // siftDown() is written for four children
+
+#if defined(__GNUC__) || defined(__clang__)
+#define HEAP_PREFETCH(address) __builtin_prefetch(address)
+#else
+#include <xmmintrin.h>
+#define HEAP_PREFETCH(address) _mm_prefetch(reinterpret_cast<const char *>(address), _MM_HINT_T0)
+#endif
+
+// Floyd's bottom-up sift-down in a max-heap of the given size: the hole at
+// node follows the larger children down to a leaf without comparing them to
+// the sifted key, which then climbs back up to its place. The key usually
+// belongs near the bottom, so the climb is short and most levels cost three
+// comparisons instead of four.
+template <typename Counters>
+inline void siftDown(int *heap, std::ptrdiff_t node, std::ptrdiff_t size, Counters &counters)
+{
+    int value = heap[node];
+    std::ptrdiff_t hole = node;
+
+    // Descend: the largest child moves up into the hole
+    std::ptrdiff_t child;
+    while ((child = hole * heapArity + 1) + heapArity <= size)
+    {
+        // The grandchildren fill one or two cache lines; fetch them while
+        // the children are compared
+        const int *grandchildren = heap + child * heapArity + 1;
+        if (grandchildren < heap + size)
+        {
+            HEAP_PREFETCH(grandchildren);
+            HEAP_PREFETCH(grandchildren + heapArity * heapArity - 1);
+        }
+
+        // Tournament: two independent pairs, then the winners. The keys are
+        // kept in registers and the index is picked arithmetically, since a
+        // compiler branch here would be mispredicted half the time.
+        int a = heap[child];
+        int b = heap[child + 1];
+        int c = heap[child + 2];
+        int d = heap[child + 3];
+        std::ptrdiff_t left = a < b;
+        std::ptrdiff_t right = 2 + (c < d);
+        int leftKey = a < b ? b : a;
+        int rightKey = c < d ? d : c;
+        std::ptrdiff_t rightWins = leftKey < rightKey;
+        counters.comparisons += heapArity - 1;
+
+        heap[hole] = rightWins ? rightKey : leftKey;
+        counters.writes++;
+        hole = child + left + ((right - left) & -rightWins);
+    }
+
+    // The last internal node may have fewer children
+    if (child < size)
+    {
+        std::ptrdiff_t largest = child;
+        for (std::ptrdiff_t k = child + 1; k < size; ++k)
+        {
+            largest = heap[largest] < heap[k] ? k : largest;
+        }
+        counters.comparisons += size - child - 1;
+
+        heap[hole] = heap[largest];
+        counters.writes++;
+        hole = largest;
+    }
+
+    // Climb: parents smaller than the key move back down
+    while (hole > node)
+    {
+        std::ptrdiff_t parent = (hole - 1) / heapArity;
+        counters.comparisons++;
+        if (!(heap[parent] < value))
+        {
+            break;
+        }
+        heap[hole] = heap[parent];
+        counters.writes++;
+        hole = parent;
+    }
+
+    heap[hole] = value;
+    counters.writes++;
+}
+
+// Where a heap over [first, last) should start so that every group of
+// siblings is 16-byte aligned. The keys skipped at the front, fewer than
+// heapArity, are merged in by finishHeapSort(). Small ranges start at first.
+inline int *alignedHeapStart(int *first, int *last)
+{
+    const std::size_t groupBytes = heapArity * sizeof(int);
+    if (last - first < 16 * heapArity)
+    {
+        return first;
+    }
+
+    // Siblings start at heap + 1 + i * heapArity
+    std::size_t offset = reinterpret_cast<std::uintptr_t>(first + 1) % groupBytes;
+    return first + (groupBytes - offset) % groupBytes / sizeof(int);
+}
+
+// Turn [heap, last) into a max-heap
+template <typename Counters>
+inline void buildHeap(int *heap, int *last, Counters &counters)
+{
+    std::ptrdiff_t size = last - heap;
+    for (std::ptrdiff_t node = size > 1 ? (size - 2) / heapArity : -1; node >= 0; --node)
+    {
+        siftDown(heap, node, size, counters);
+    }
+}
+
+// Move the largest key of the heap [heap, end) to end - 1 and restore the
+// heap over [heap, end - 1)
+template <typename Counters>
+inline void popHeap(int *heap, int *end, Counters &counters)
+{
+    std::ptrdiff_t size = end - heap - 1;
+    std::swap(heap[0], heap[size]);
+    counters.swaps++;
+    counters.writes += 2;
+    if (size > 1)
+    {
+        siftDown(heap, 0, size, counters);
+    }
+}
+
+// Merge the keys skipped before the heap, [first, heap), into the sorted
+// [heap, last). Each finds its place by binary search and the keys before it
+// are moved down in one go, so this costs at most one pass of moves.
+template <typename Counters>
+inline void finishHeapSort(int *first, int *heap, int *last, Counters &counters)
+{
+    if (first == heap)
+    {
+        return;
+    }
+
+    insertionSort(first, heap, counters);
+    int skipped[heapArity];
+    int *skippedEnd = std::copy(first, heap, skipped);
+
+    int *out = first;
+    int *run = heap;
+    for (const int *key = skipped; key < skippedEnd; ++key)
+    {
+        int *stop = std::partition_point(run, last, [&](int value)
+                                         {
+                                             counters.comparisons++;
+                                             return !(*key < value); });
+        out = std::copy(run, stop, out);
+        run = stop;
+        *out++ = *key;
+    }
+    counters.writes += run - first;
+}
+
+// Bottom-up heapsort on the aligned 4-ary heap: O(n log n) in the worst case
+// with O(1) extra memory, the fallback for introsort
+template <typename Counters>
+inline void heapSort(int *first, int *last, Counters &counters)
+{
+    int *heap = alignedHeapStart(first, last);
+    buildHeap(heap, last, counters);
+    for (int *end = last; end - heap > 1; --end)
+    {
+        popHeap(heap, end, counters);
+    }
+    finishHeapSort(first, heap, last, counters);
+}
+
+// floor(log2(n)) for n >= 1, used to derive introsort depth limits
+inline int floorLog2(std::ptrdiff_t n)
+{
+    int log = 0;
+    while (n > 1)
+    {
+        n >>= 1;
+        ++log;
+    }
+    return log;
+}
+
+// Sequential block quicksort of [first, last), the algorithm of Block Quick
+// Sort without the stepping: recurses into the smaller side, loops on the
+// larger one and leaves small ranges to a sorting network. Unless leftmost,
+// *(first - 1) must bound the range from below.
+template <typename Counters>
+inline void quickSortRange(int *first, int *last, bool leftmost, int depthLimit, Counters &counters)
+{
+    const std::ptrdiff_t networkSortThreshold = 24;
+
+    while (last - first > networkSortThreshold)
+    {
+        if (depthLimit == 0)
+        {
+            heapSort(first, last, counters);
+            return;
+        }
+
+        selectPivotToFront(first, last, counters);
+
+        // Keys equal to the predecessor, a previous pivot, are already in place
+        if (!leftmost)
+        {
+            counters.comparisons++;
+            if (!(*(first - 1) < *first))
+            {
+                first = partitionEqualLeft(first, last, counters) + 1;
+                continue;
+            }
+        }
+
+        int *pivot = partitionBlock(first, last, counters);
+        --depthLimit;
+
+        if (pivot - first < last - pivot)
+        {
+            quickSortRange(first, pivot, leftmost, depthLimit, counters);
+            first = pivot + 1;
+            leftmost = false;
+        }
+        else
+        {
+            quickSortRange(pivot + 1, last, false, depthLimit, counters);
+            last = pivot;
+        }
+    }
+
+    networkSort(first, last, counters);
+}
@@ -1,6 +1,9 @@
 #include "SortManager.h"
 #include "SortAlgorithm.h"
 #include <stdexcept>
+#include <chrono>
+#include <limits>
+#include <algorithm>
 
 SortManager::SortManager()
 {
@@ -18,15 +21,16 @@ void SortManager::registerAlgorithms()
     algorithms_.clear();
     algorithmNames_.clear();
 
-    // Add algorithm names in desired order
-    algorithmNames_.push_back("Bubble Sort");
-    algorithmNames_.push_back("Quick Sort");
-    algorithmNames_.push_back("Merge Sort");
+    // Add algorithm names in desired order, the generated variants last
+    algorithmNames_ = getSortAlgorithmNames();
+    const auto &variantNames = getSortVariantNames();
+    algorithmNames_.insert(algorithmNames_.end(), variantNames.begin(), variantNames.end());
 
     // Create algorithm instances
     for (const auto &name : algorithmNames_)
     {
         algorithms_[name] = createSortAlgorithm(name);
+        algorithms_[name]->getMetrics().costModel = costModel_;
     }
 }
 
@@ -61,25 +65,71 @@ bool SortManager::setAlgorithm(int index)
     return false;
 }
 
+void SortManager::setCostModel(const CostModel &model)
+{
+    costModel_ = model;
+    for (auto &entry : algorithms_)
+    {
+        entry.second->getMetrics().costModel = costModel_;
+    }
+}
+
 void SortManager::initializeSort()
 {
     if (currentAlgorithm_)
     {
+        auto start = std::chrono::steady_clock::now();
+        currentAlgorithm_->setValueRange(array_.getMinVal(), array_.getMaxVal());
         currentAlgorithm_->initialize(array_.getArray());
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        currentAlgorithm_->getMetrics().addComputeTime(elapsed.count());
     }
 }
 
-bool SortManager::updateSort()
+bool SortManager::updateSort(size_t steps)
 {
     if (currentAlgorithm_ && currentAlgorithm_->getMetrics().isRunning)
     {
-        bool continueSort = currentAlgorithm_->update();
-        
+        if (turboMode_)
+        {
+            steps = std::numeric_limits<size_t>::max();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool continueSort = currentAlgorithm_->runSteps(steps);
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        currentAlgorithm_->getMetrics().addComputeTime(elapsed.count());
+
+        if (!continueSort)
+        {
+            // Finished: stop the clock so the final elapsed time is kept
+            currentAlgorithm_->stop();
+            recordRun();
+        }
+
         return continueSort;
     }
     return false;
 }
 
+void SortManager::recordRun()
+{
+    const SortMetrics &metrics = currentAlgorithm_->getMetrics();
+    RunRecord record;
+    record.algorithm = currentAlgorithmName_;
+    record.size = array_.getSize();
+    record.comparisons = metrics.comparisons;
+    record.writes = metrics.writes;
+    record.computeTime = metrics.getComputeTime();
+
+    // A new run replaces the algorithm's previous one
+    runRecords_.erase(std::remove_if(runRecords_.begin(), runRecords_.end(),
+                                     [&](const RunRecord &r)
+                                     { return r.algorithm == record.algorithm; }),
+                      runRecords_.end());
+    runRecords_.push_back(record);
+}
+
 void SortManager::stopSort()
 {
     if (currentAlgorithm_)
@@ -10,6 +10,17 @@
 class SortManager
 {
 public:
+    // Operation counts of an algorithm's last finished sort, kept so the
+    // modeled costs of different algorithms can be compared
+    struct RunRecord
+    {
+        std::string algorithm;
+        int size = 0;
+        long long comparisons = 0;
+        long long writes = 0;
+        double computeTime = 0.0;
+    };
+
     SortManager();
     ~SortManager() = default;
 
@@ -31,8 +42,9 @@ public:
     // Initialize sorting
     void initializeSort();
 
-    // Update the sort process
-    bool updateSort();
+    // Advance the sort process by up to the given number of steps
+    // (in turbo mode the sort always runs to completion)
+    bool updateSort(size_t steps = 1);
 
     // Stop sorting
     void stopSort();
@@ -40,6 +52,18 @@ public:
     // Reset sorting state
     void resetSort();
 
+    // Turbo mode: sort at full native speed instead of animating step by step
+    void setTurboMode(bool enabled) { turboMode_ = enabled; }
+    bool isTurboMode() const { return turboMode_; }
+
+    // Operation costs charged in the modeled time of every algorithm; the
+    // default model charges nothing
+    void setCostModel(const CostModel &model);
+    const CostModel &getCostModel() const { return costModel_; }
+
+    // Last finished sort of each algorithm, in the order they finished
+    const std::vector<RunRecord> &getRunRecords() const { return runRecords_; }
+
     // Check if sorting is in progress
     bool isSorting() const;
 
@@ -54,9 +78,15 @@ public:
     const SortArray &getSortArray() const { return array_; }
 
 private:
+    // Remember the operation counts of the sort that just finished
+    void recordRun();
+
     SortArray array_;
     std::vector<std::string> algorithmNames_;
     std::unordered_map<std::string, std::unique_ptr<SortAlgorithm>> algorithms_;
     SortAlgorithm *currentAlgorithm_ = nullptr;
     std::string currentAlgorithmName_;
+    bool turboMode_ = false;
+    CostModel costModel_;
+    std::vector<RunRecord> runRecords_;
 };
\ No newline at end of file
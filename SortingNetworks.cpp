@@ -0,0 +1,206 @@
+#include "SortingNetworks.h"
+#include "SimdPartition.h"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define SORTING_NETWORKS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#define TARGET_AVX2
+#define TARGET_AVX512
+#else
+#define TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define TARGET_AVX512 __attribute__((target("avx512f,popcnt")))
+#endif
+#endif
+
+namespace
+{
+    // Sorts the columns of a size x lanes matrix in place: row i holds key i
+    // of every array
+    using RowSort = void (*)(int *rows);
+
+#ifdef SORTING_NETWORKS_X86
+    TARGET_AVX2 inline void compareExchangeAvx2(__m256i &low, __m256i &high)
+    {
+        __m256i a = low;
+        low = _mm256_min_epi32(a, high);
+        high = _mm256_max_epi32(a, high);
+    }
+
+    template <int Size, std::size_t... Index>
+    TARGET_AVX2 inline void applyNetworkAvx2(__m256i *rows, std::index_sequence<Index...>)
+    {
+        using Network = SortingNetwork<Size>;
+        static_cast<void>(rows); // Unused by the empty networks
+        (compareExchangeAvx2(rows[Network::comparators[Index].low], rows[Network::comparators[Index].high]), ...);
+    }
+
+    template <int Size>
+    TARGET_AVX2 void sortRowsAvx2(int *rows)
+    {
+        __m256i lanes[Size > 0 ? Size : 1];
+        for (int i = 0; i < Size; ++i)
+        {
+            lanes[i] = _mm256_load_si256(reinterpret_cast<const __m256i *>(rows + 8 * i));
+        }
+        applyNetworkAvx2<Size>(lanes, std::make_index_sequence<SortingNetwork<Size>::count>());
+        for (int i = 0; i < Size; ++i)
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i *>(rows + 8 * i), lanes[i]);
+        }
+    }
+
+    TARGET_AVX512 inline void compareExchangeAvx512(__m512i &low, __m512i &high)
+    {
+        // The zero-masking forms sidestep GCC 12's uninitialised-value
+        // warning for the plain ones
+        __m512i a = low;
+        low = _mm512_maskz_min_epi32(0xFFFF, a, high);
+        high = _mm512_maskz_max_epi32(0xFFFF, a, high);
+    }
+
+    template <int Size, std::size_t... Index>
+    TARGET_AVX512 inline void applyNetworkAvx512(__m512i *rows, std::index_sequence<Index...>)
+    {
+        using Network = SortingNetwork<Size>;
+        static_cast<void>(rows); // Unused by the empty networks
+        (compareExchangeAvx512(rows[Network::comparators[Index].low], rows[Network::comparators[Index].high]), ...);
+    }
+
+    template <int Size>
+    TARGET_AVX512 void sortRowsAvx512(int *rows)
+    {
+        __m512i lanes[Size > 0 ? Size : 1];
+        for (int i = 0; i < Size; ++i)
+        {
+            lanes[i] = _mm512_load_si512(rows + 16 * i);
+        }
+        applyNetworkAvx512<Size>(lanes, std::make_index_sequence<SortingNetwork<Size>::count>());
+        for (int i = 0; i < Size; ++i)
+        {
+            _mm512_store_si512(rows + 16 * i, lanes[i]);
+        }
+    }
+
+    template <std::size_t... Size>
+    constexpr std::array<RowSort, sizeof...(Size)> makeAvx2Table(std::index_sequence<Size...>)
+    {
+        return {{&sortRowsAvx2<static_cast<int>(Size)>...}};
+    }
+
+    template <std::size_t... Size>
+    constexpr std::array<RowSort, sizeof...(Size)> makeAvx512Table(std::index_sequence<Size...>)
+    {
+        return {{&sortRowsAvx512<static_cast<int>(Size)>...}};
+    }
+
+    constexpr std::array<RowSort, maxNetworkSize + 1> avx2Networks =
+        makeAvx2Table(std::make_index_sequence<maxNetworkSize + 1>());
+    constexpr std::array<RowSort, maxNetworkSize + 1> avx512Networks =
+        makeAvx512Table(std::make_index_sequence<maxNetworkSize + 1>());
+
+    // Every lane is exchanged with its neighbour in the pair: the even lanes
+    // keep the smaller keys, the odd lanes the larger
+    TARGET_AVX2 long long transpositionPhaseAvx2(int *&first, int *last)
+    {
+        long long exchanged = 0;
+        for (; last - first >= 8; first += 8)
+        {
+            __m256i keys = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(first));
+            __m256i partners = _mm256_shuffle_epi32(keys, _MM_SHUFFLE(2, 3, 0, 1));
+            __m256i greater = _mm256_cmpgt_epi32(keys, partners);
+            exchanged += _mm_popcnt_u32(static_cast<unsigned int>(_mm256_movemask_ps(_mm256_castsi256_ps(greater))) & 0x55);
+
+            __m256i sorted = _mm256_blend_epi32(_mm256_min_epi32(keys, partners), _mm256_max_epi32(keys, partners), 0xAA);
+            _mm256_storeu_si256(reinterpret_cast<__m256i *>(first), sorted);
+        }
+        return exchanged;
+    }
+
+    TARGET_AVX512 long long transpositionPhaseAvx512(int *&first, int *last)
+    {
+        long long exchanged = 0;
+        for (; last - first >= 16; first += 16)
+        {
+            __m512i keys = _mm512_loadu_si512(first);
+            __m512i partners = _mm512_maskz_shuffle_epi32(0xFFFF, keys, _MM_PERM_CDAB);
+            exchanged += _mm_popcnt_u32(_mm512_cmpgt_epi32_mask(keys, partners) & 0x5555);
+
+            __m512i smaller = _mm512_maskz_min_epi32(0xFFFF, keys, partners);
+            _mm512_storeu_si512(first, _mm512_mask_max_epi32(smaller, 0xAAAA, keys, partners));
+        }
+        return exchanged;
+    }
+#endif
+}
+
+void networkSortBatch(int *keys, int arrays, int size)
+{
+    int done = 0;
+
+#ifdef SORTING_NETWORKS_X86
+    SimdLevel level = detectSimdLevel();
+    if (level != SimdLevel::Scalar && size > 1)
+    {
+        int lanes = level == SimdLevel::AVX512 ? 16 : 8;
+        RowSort sortRows = level == SimdLevel::AVX512 ? avx512Networks[size] : avx2Networks[size];
+        alignas(64) int rows[maxNetworkSize * 16];
+
+        for (; done + lanes <= arrays; done += lanes)
+        {
+            // Transpose the group so each row is one vector
+            int *group = keys + static_cast<std::ptrdiff_t>(done) * size;
+            for (int array = 0; array < lanes; ++array)
+            {
+                for (int i = 0; i < size; ++i)
+                {
+                    rows[i * lanes + array] = group[array * size + i];
+                }
+            }
+
+            sortRows(rows);
+
+            for (int array = 0; array < lanes; ++array)
+            {
+                for (int i = 0; i < size; ++i)
+                {
+                    group[array * size + i] = rows[i * lanes + array];
+                }
+            }
+        }
+    }
+#endif
+
+    for (; done < arrays; ++done)
+    {
+        networkTable[size].sort(keys + static_cast<std::ptrdiff_t>(done) * size);
+    }
+}
+
+long long transpositionPhase(int *first, int *last)
+{
+    long long exchanged = 0;
+
+#ifdef SORTING_NETWORKS_X86
+    switch (detectSimdLevel())
+    {
+    case SimdLevel::AVX512:
+        exchanged += transpositionPhaseAvx512(first, last);
+        break;
+    case SimdLevel::AVX2:
+        exchanged += transpositionPhaseAvx2(first, last);
+        break;
+    default:
+        break;
+    }
+#endif
+
+    // Pairs left over, or all of them without vector support
+    for (; last - first >= 2; first += 2)
+    {
+        bool greater = first[1] < first[0];
+        exchanged += greater;
+        compareExchange(first[0], first[1]);
+    }
+    return exchanged;
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+// Sorting networks for up to 32 keys, generated at compile time: Batcher's
+// odd-even merge sort on the next power of two, minus every comparator that
+// touches a lane beyond the size (those lanes would hold +infinity and never
+// move). A network is a fixed sequence of compare-exchanges, so it sorts
+// without data-dependent branches: as min/max pairs in registers for a single
+// array, or on vectors holding one key of 8 or 16 arrays at once.
+
+constexpr int maxNetworkSize = 32;
+
+struct Comparator
+{
+    int low;  // Receives the smaller key
+    int high; // Receives the larger key
+};
+
+// Visit the comparators of the network for size keys in order
+template <typename Visit>
+constexpr void forEachComparator(int size, Visit &&visit)
+{
+    int lanes = 1;
+    while (lanes < size)
+    {
+        lanes *= 2;
+    }
+
+    for (int p = 1; p < lanes; p *= 2)
+    {
+        for (int k = p; k >= 1; k /= 2)
+        {
+            for (int j = k % p; j + k < lanes; j += 2 * k)
+            {
+                for (int i = 0; i < k && i + j + k < lanes; ++i)
+                {
+                    // Only keys within the same merge of two runs of p lanes are compared
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < size)
+                    {
+                        visit(i + j, i + j + k);
+                    }
+                }
+            }
+        }
+    }
+}
+
+constexpr int countComparators(int size)
+{
+    int count = 0;
+    forEachComparator(size, [&count](int, int)
+                      { ++count; });
+    return count;
+}
+
+template <int Size>
+struct SortingNetwork
+{
+    static_assert(Size >= 0 && Size <= maxNetworkSize, "networks cover up to maxNetworkSize keys");
+
+    static constexpr int size = Size;
+    static constexpr int count = countComparators(Size);
+
+    static constexpr std::array<Comparator, count> build()
+    {
+        std::array<Comparator, count> comparators{};
+        int next = 0;
+        forEachComparator(Size, [&](int low, int high)
+                          { comparators[next++] = {low, high}; });
+        return comparators;
+    }
+
+    static constexpr std::array<Comparator, count> comparators = build();
+};
+
+// Branch-free compare-exchange, compiled to min/max or conditional moves
+inline void compareExchange(int &low, int &high)
+{
+    int a = low;
+    int b = high;
+    low = b < a ? b : a;
+    high = b < a ? a : b;
+}
+
+template <int Size, std::size_t... Index>
+inline void applyNetwork(int *keys, std::index_sequence<Index...>)
+{
+    using Network = SortingNetwork<Size>;
+    static_cast<void>(keys); // Unused by the empty networks
+    (compareExchange(keys[Network::comparators[Index].low], keys[Network::comparators[Index].high]), ...);
+}
+
+// Sort exactly Size keys. They are copied into a local array first so the
+// fully unrolled network can keep them in registers.
+template <int Size>
+inline void sortNetwork(int *keys)
+{
+    int lanes[Size > 0 ? Size : 1];
+    for (int i = 0; i < Size; ++i)
+    {
+        lanes[i] = keys[i];
+    }
+    applyNetwork<Size>(lanes, std::make_index_sequence<SortingNetwork<Size>::count>());
+    for (int i = 0; i < Size; ++i)
+    {
+        keys[i] = lanes[i];
+    }
+}
+
+struct NetworkEntry
+{
+    void (*sort)(int *keys);
+    int comparators;
+};
+
+template <std::size_t... Size>
+constexpr std::array<NetworkEntry, sizeof...(Size)> makeNetworkTable(std::index_sequence<Size...>)
+{
+    return {{{&sortNetwork<static_cast<int>(Size)>, SortingNetwork<static_cast<int>(Size)>::count}...}};
+}
+
+// One network per size from 0 to maxNetworkSize
+inline constexpr std::array<NetworkEntry, maxNetworkSize + 1> networkTable =
+    makeNetworkTable(std::make_index_sequence<maxNetworkSize + 1>());
+
+// Sort [first, last), at most maxNetworkSize keys, with the network for its size
+template <typename Counters>
+inline void networkSort(int *first, int *last, Counters &counters)
+{
+    const NetworkEntry &network = networkTable[last - first];
+    network.sort(first);
+    counters.comparisons += network.comparators;
+    counters.writes += last - first;
+}
+
+// Sort arrays consecutive arrays of size keys each (size <= maxNetworkSize).
+// Groups of 16 (AVX-512) or 8 (AVX2) arrays are sorted together, one array per
+// vector lane; the rest, and CPUs without those instruction sets, go through
+// the scalar networks.
+void networkSortBatch(int *keys, int arrays, int size);
+
+// One phase of odd-even transposition sort: compare-exchange the pairs
+// (first[0], first[1]), (first[2], first[3]), ... of [first, last); a last
+// key without a partner is left alone. The pairs are independent, so they are
+// done 8 or 16 at a time with vector min/max when the CPU allows. Returns how
+// many pairs were out of order.
+long long transpositionPhase(int *first, int *last);
@@ -0,0 +1,138 @@
+#include "ThreadPool.h"
+
+namespace
+{
+    // Index of the pool worker running on this thread, or -1 outside any task
+    thread_local int currentWorker = -1;
+
+    std::mutex sharedMutex;
+    int sharedThreadCount = 0;
+    bool sharedCreated = false;
+}
+
+ThreadPool::ThreadPool(int threadCount)
+{
+    if (threadCount <= 0)
+    {
+        threadCount = static_cast<int>(std::thread::hardware_concurrency());
+    }
+
+    for (int worker = 1; worker < threadCount; ++worker)
+    {
+        threads_.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    for (auto &thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::parallelFor(int count, const Task &task)
+{
+    if (count <= 0)
+    {
+        return;
+    }
+
+    // Nested calls, single tasks and single-threaded pools run inline
+    if (currentWorker >= 0 || threads_.empty() || count == 1)
+    {
+        int worker = currentWorker >= 0 ? currentWorker : 0;
+        for (int index = 0; index < count; ++index)
+        {
+            task(index, worker);
+        }
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(submitMutex_);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        task_ = &task;
+        taskCount_ = count;
+        nextTask_.store(0, std::memory_order_relaxed);
+        busyWorkers_ = static_cast<int>(threads_.size());
+        ++generation_;
+    }
+    wake_.notify_all();
+
+    currentWorker = 0;
+    runTasks(0);
+    currentWorker = -1;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this]
+               { return busyWorkers_ == 0; });
+    task_ = nullptr;
+}
+
+ThreadPool &ThreadPool::getShared()
+{
+    static ThreadPool pool([]
+                           {
+                               std::lock_guard<std::mutex> lock(sharedMutex);
+                               sharedCreated = true;
+                               return sharedThreadCount; }());
+    return pool;
+}
+
+bool ThreadPool::configureShared(int threadCount)
+{
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    if (sharedCreated)
+    {
+        return false;
+    }
+    sharedThreadCount = threadCount;
+    return true;
+}
+
+void ThreadPool::workerLoop(int worker)
+{
+    currentWorker = worker;
+    unsigned long long seenGeneration = 0;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wake_.wait(lock, [&]
+                       { return stopping_ || generation_ != seenGeneration; });
+            if (stopping_)
+            {
+                return;
+            }
+            seenGeneration = generation_;
+        }
+
+        runTasks(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--busyWorkers_ == 0)
+            {
+                done_.notify_one();
+            }
+        }
+    }
+}
+
+void ThreadPool::runTasks(int worker)
+{
+    int index;
+    while ((index = nextTask_.fetch_add(1, std::memory_order_relaxed)) < taskCount_)
+    {
+        (*task_)(index, worker);
+    }
+}
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads shared by the parallel sorting algorithms.
+// The calling thread always takes part as worker 0, so a pool on a
+// single-core machine simply runs everything inline.
+class ThreadPool
+{
+public:
+    using Task = std::function<void(int index, int worker)>;
+
+    // threadCount counts the calling thread; 0 means one per hardware thread
+    explicit ThreadPool(int threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    // Number of workers, including the calling thread
+    int getThreadCount() const { return static_cast<int>(threads_.size()) + 1; }
+
+    // Run task(index, worker) for every index in [0, count) and wait for all of
+    // them. Indices are handed out dynamically; worker is in [0, getThreadCount()).
+    // Calls made from inside a task run inline on the current worker.
+    void parallelFor(int count, const Task &task);
+
+    // Process-wide pool, sized to the machine unless configured first
+    static ThreadPool &getShared();
+
+    // Choose the shared pool's thread count; only possible before its first use
+    static bool configureShared(int threadCount);
+
+private:
+    void workerLoop(int worker);
+    void runTasks(int worker);
+
+    std::vector<std::thread> threads_;
+    std::mutex submitMutex_; // Serialises parallelFor() callers
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    const Task *task_ = nullptr;
+    int taskCount_ = 0;
+    std::atomic<int> nextTask_{0};
+    int busyWorkers_ = 0;
+    unsigned long long generation_ = 0;
+    bool stopping_ = false;
+};
+
+// Task deque for work stealing: its owner pushes and pops at the back (LIFO,
+// so it keeps working on the freshest, cache-warm task), while idle workers
+// steal from the front, where the oldest and usually largest tasks are.
+template <typename T>
+class alignas(64) WorkStealingDeque
+{
+public:
+    void push(const T &item)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.push_back(item);
+    }
+
+    bool pop(T &item)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty())
+        {
+            return false;
+        }
+        item = items_.back();
+        items_.pop_back();
+        return true;
+    }
+
+    bool steal(T &item)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty())
+        {
+            return false;
+        }
+        item = items_.front();
+        items_.pop_front();
+        return true;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.clear();
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<T> items_;
+};
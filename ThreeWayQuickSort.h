@@ -0,0 +1,82 @@
+#pragma once
+
+#include "SortAlgorithm.h"
+#include "SortKernels.h"
+#include <vector>
+#include <stack>
+
+// Quick Sort with a three-way (fat pivot) partition: keys equal to the pivot
+// are gathered in the middle and never revisited, so inputs with many
+// duplicates sort in near-linear time. One partition is processed per update().
+class ThreeWayQuickSort final : public SteppedSortAlgorithm<ThreeWayQuickSort>
+{
+public:
+    ThreeWayQuickSort() : SteppedSortAlgorithm("3-Way Quick Sort") {}
+
+    void initialize(std::vector<int> &array) override
+    {
+        array_ = &array; // Store a reference to the original array
+        sortStack_ = std::stack<std::pair<int, int>>();
+
+        if (!array_->empty())
+        {
+            sortStack_.push({0, static_cast<int>(array_->size() - 1)});
+        }
+
+        metrics_.resetMetrics();
+        metrics_.isRunning = true;
+        metrics_.startTimer();
+    }
+
+    bool update() override
+    {
+        if (!metrics_.isRunning || sortStack_.empty())
+        {
+            metrics_.isRunning = false;
+            return false;
+        }
+
+        // Get the next partition to process
+        auto top = sortStack_.top();
+        sortStack_.pop();
+
+        int *first = array_->data() + top.first;
+        int *last = array_->data() + top.second + 1;
+
+        if (last - first <= insertionSortThreshold)
+        {
+            insertionSort(first, last, metrics_);
+        }
+        else
+        {
+            selectPivotToFront(first, last, metrics_);
+            auto equal = partitionThreeWay(first, last, metrics_);
+
+            int lt = static_cast<int>(equal.first - array_->data());
+            int gt = static_cast<int>(equal.second - array_->data());
+
+            // Push the larger side first so the smaller one is processed next
+            std::pair<int, int> left = {top.first, lt - 1};
+            std::pair<int, int> right = {gt, top.second};
+            if (lt - top.first < top.second - gt + 1)
+            {
+                std::swap(left, right);
+            }
+            sortStack_.push(left);
+            sortStack_.push(right);
+        }
+
+        return !sortStack_.empty();
+    }
+
+    const std::vector<int> &getCurrentArray() const override
+    {
+        return *array_;
+    }
+
+private:
+    static const int insertionSortThreshold = 16;
+
+    std::vector<int> *array_; // Pointer to the original array
+    std::stack<std::pair<int, int>> sortStack_;
+};